@@ -0,0 +1,289 @@
+/*
+ * Cli Calc -- a small CLI calculator
+ * Copyright (C) 2012 David Jolly
+ * ----------------------
+ * This file is part of Cli Calc
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <sstream>
+#include "byte_code.hpp"
+#include "exc_code.hpp"
+#include "lexer.hpp"
+#include "sym_table.hpp"
+
+/*
+ * Instruction operations
+ */
+const std::string byte_code::OP_DATA[15] = { "CALL", "CHECK", "CONSTANT", "FAIL", "FETCH", "LITERAL", "LOAD", "NEGATE", "OPER",
+		"PRODUCT", "ROUND", "SHIFT", "STORE", "SUM", "TAKE" };
+
+/*
+ * Byte code assignment
+ */
+byte_code &byte_code::operator=(const byte_code &other) {
+
+	// check for self-assignment
+	if(this == &other)
+		return *this;
+
+	// set attributes
+	depth = other.depth;
+	program = other.program;
+	literals = other.literals;
+	return *this;
+}
+
+/*
+ * Adds a literal to the program, taking the given value, returning its index
+ */
+unsigned int byte_code::add_literal(num_value &value) {
+	literals.push_back(num_value());
+	literals.back().swap(value);
+	return literals.size() - 1;
+}
+
+/*
+ * Release the program & its literals
+ */
+void byte_code::clear(void) {
+	depth = 0;
+	program.clear();
+	literals.clear();
+}
+
+/*
+ * Compiles the expression at the tree's current token into a program, taking the values of its literals
+ * (statements that fail to evaluate compile to a program that throws at the point of failure)
+ */
+void byte_code::compile(syn_tree &tree) {
+	clear();
+	compile_expression(tree.get_current(), 0);
+}
+
+/*
+ * Compiles an expression token (stack holds height values before it is evaluated), returning false
+ * if a failure was emitted
+ */
+bool byte_code::compile_expression(token *tok, unsigned int height) {
+	unsigned int type;
+	token *child = tok->get_first();
+
+	// verify token is of type expression
+	if(tok->get_type() != token::EXPRESSION) {
+		emit(FAIL, 0, exc_code::INVALID_EXPRESSION);
+		return false;
+	}
+
+	// an empty expression evaluates to an undefined value
+	if(!child) {
+		num_value value;
+		emit(LITERAL, 0, add_literal(value));
+		if(height + 1 > depth)
+			depth = height + 1;
+		return true;
+	}
+
+	// compile first token
+	if(!compile_operand(child, height))
+		return false;
+
+	// check the first operand unless it is known to be a number
+	if(child->get_next()) {
+		instruction &last = program.back();
+		if(last.op == LOAD
+				|| last.op == NEGATE
+				|| (last.op == LITERAL
+				&& !literals[last.code].is_integer()
+				&& !literals[last.code].is_float()))
+			emit(CHECK, 0, 0);
+	}
+
+	// compile each operator & its second operand left to right
+	for(child = child->get_next(); child; child = child->get_next()) {
+		type = child->get_type();
+		if(child->size() != 1
+				|| (type != token::BINARY_OPER
+				&& type != token::LOGICAL_OPER
+				&& type != token::OPER)) {
+			emit(FAIL, 0, exc_code::INVALID_EXPRESSION);
+			return false;
+		}
+		if(!compile_expression(child->get_first(), height + 1))
+			return false;
+		emit(OPER, type, child->get_code());
+	}
+	return true;
+}
+
+/*
+ * Compiles the first operand of an expression, returning false if a failure was emitted
+ */
+bool byte_code::compile_operand(token *tok, unsigned int height) {
+
+	// compile based off token type
+	switch(tok->get_type()) {
+
+		// compile as a constant
+		case token::CONSTANT: emit(CONSTANT, 0, tok->get_code());
+			break;
+
+		// compile as an expression
+		case token::EXPRESSION:
+			return compile_expression(tok, height);
+
+		// compile as a function of its expression
+		case token::FUNCTION:
+			if(tok->size() != 1) {
+				emit(FAIL, 0, exc_code::INVALID_FUNCTION);
+				return false;
+			} else if(!compile_expression(tok->get_first(), height))
+				return false;
+			emit(CALL, 0, tok->get_code());
+			return true;
+
+		// compile as a literal (taking its value)
+		case token::FLOAT:
+		case token::INTEGER:
+			emit(LITERAL, 0, add_literal(tok->get_value()));
+			break;
+
+		// compile as a load of its interned identifier
+		case token::STRING: emit(LOAD, 0, sym_table::intern(tok->get_text()));
+			break;
+
+		// compile as a unary operator of its expression
+		case token::UNARY_OPER:
+			if(tok->get_code() != lexer::NOT) {
+				emit(FAIL, 0, exc_code::INVALID_UNARY_OPERATOR);
+				return false;
+			} else if(!tok->size()) {
+				emit(FAIL, 0, exc_code::INVALID_EXPRESSION);
+				return false;
+			} else if(!compile_expression(tok->get_first(), height))
+				return false;
+			emit(NEGATE, 0, 0);
+			return true;
+		default:
+			emit(FAIL, 0, exc_code::INVALID_EXPRESSION);
+			return false;
+	}
+
+	// account for the value pushed
+	if(height + 1 > depth)
+		depth = height + 1;
+	return true;
+}
+
+/*
+ * Appends an instruction to the program
+ */
+void byte_code::emit(unsigned int op, unsigned int type, unsigned int code) {
+	instruction instr;
+
+	// set attributes
+	instr.op = op;
+	instr.type = type;
+	instr.code = code;
+	program.push_back(instr);
+}
+
+/*
+ * Recomputes the maximum number of values held on the stack from the program's instructions
+ */
+void byte_code::measure(void) {
+	unsigned int height = 0;
+
+	// track the height of the stack after each instruction
+	depth = 0;
+	for(std::vector<instruction>::iterator i = program.begin(); i != program.end(); ++i) {
+		switch(i->op) {
+
+			// instructions that push a value
+			case CONSTANT:
+			case FETCH:
+			case LITERAL:
+			case LOAD:
+			case TAKE: height++;
+				break;
+
+			// instructions that pop operands, pushing their result
+			case OPER: height--;
+				break;
+			case PRODUCT:
+			case SUM: height -= i->code - 1;
+				break;
+
+			// instructions holding their literal above the stack while they evaluate (as a float)
+			case SHIFT:
+				if(height + 1 > depth)
+					depth = height + 1;
+				break;
+			default:
+				break;
+		}
+		if(height > depth)
+			depth = height;
+	}
+}
+
+/*
+ * Returns a string representation of the program
+ */
+void byte_code::to_string(std::string &str) {
+	std::string val;
+	std::stringstream ss;
+
+	// write each instruction on its own line
+	ss << "Depth: " << depth << std::endl;
+	for(std::vector<instruction>::iterator i = program.begin(); i != program.end(); ++i) {
+		ss << OP_DATA[i->op];
+		switch(i->op) {
+			case LITERAL:
+				val.clear();
+				literals[i->code].to_string(val);
+				ss << " " << val;
+				break;
+			case SHIFT:
+				val.clear();
+				literals[i->code].to_string(val);
+				ss << " " << lexer::OPER_DATA[i->type] << " " << val;
+				break;
+			case OPER:
+				if(i->type == token::BINARY_OPER)
+					ss << " " << lexer::BINARY_OPER_DATA[i->code];
+				else if(i->type == token::LOGICAL_OPER)
+					ss << " " << lexer::LOGICAL_OPER_DATA[i->code];
+				else
+					ss << " " << lexer::OPER_DATA[i->code];
+				break;
+			case CALL:
+			case CONSTANT:
+			case FAIL:
+			case FETCH:
+			case LOAD:
+			case PRODUCT:
+			case STORE:
+			case SUM:
+			case TAKE:
+				ss << " " << i->code;
+				break;
+			default:
+				break;
+		}
+		ss << std::endl;
+	}
+	str.append(ss.str());
+}
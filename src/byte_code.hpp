@@ -0,0 +1,139 @@
+/*
+ * Cli Calc -- a small CLI calculator
+ * Copyright (C) 2012 David Jolly
+ * ----------------------
+ * This file is part of Cli Calc
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BYTE_CODE_HPP_
+#define BYTE_CODE_HPP_
+
+#include <string>
+#include <vector>
+#include "num_value.hpp"
+#include "syn_tree.hpp"
+#include "token.hpp"
+
+class byte_code {
+public:
+
+	/*
+	 * Instruction operations
+	 */
+	enum OP { CALL, CHECK, CONSTANT, FAIL, FETCH, LITERAL, LOAD, NEGATE, OPER, PRODUCT, ROUND, SHIFT, STORE, SUM, TAKE };
+	static const std::string OP_DATA[];
+
+	/*
+	 * Instruction (operation, operator token type & code, literal index, identifier, slot, term count or exception code)
+	 */
+	struct instruction {
+		unsigned int op;
+		unsigned int type;
+		unsigned int code;
+	};
+
+private:
+
+	unsigned int depth;
+	std::vector<instruction> program;
+	std::vector<num_value> literals;
+
+	/*
+	 * Appends an instruction to the program
+	 */
+	void emit(unsigned int op, unsigned int type, unsigned int code);
+
+	/*
+	 * Compiles an expression token (stack holds height values before it is evaluated), returning false
+	 * if a failure was emitted
+	 */
+	bool compile_expression(token *tok, unsigned int height);
+
+	/*
+	 * Compiles the first operand of an expression, returning false if a failure was emitted
+	 */
+	bool compile_operand(token *tok, unsigned int height);
+
+public:
+
+	/*
+	 * Byte code constructor
+	 */
+	byte_code(void) : depth(0) { return; }
+
+	/*
+	 * Byte code constructor
+	 */
+	byte_code(const byte_code &other) : depth(other.depth), program(other.program), literals(other.literals) { return; }
+
+	/*
+	 * Byte code destructor
+	 */
+	virtual ~byte_code(void) { clear(); }
+
+	/*
+	 * Byte code assignment
+	 */
+	byte_code &operator=(const byte_code &other);
+
+	/*
+	 * Adds a literal to the program, taking the given value, returning its index
+	 */
+	unsigned int add_literal(num_value &value);
+
+	/*
+	 * Release the program & its literals
+	 */
+	void clear(void);
+
+	/*
+	 * Compiles the expression at the tree's current token into a program, taking the values of its literals
+	 * (statements that fail to evaluate compile to a program that throws at the point of failure)
+	 */
+	void compile(syn_tree &tree);
+
+	/*
+	 * Returns the maximum number of values held on the stack while evaluating the program
+	 */
+	unsigned int get_depth(void) { return depth; }
+
+	/*
+	 * Returns the literal value at a given index
+	 */
+	num_value &get_literal(unsigned int index) { return literals[index]; }
+
+	/*
+	 * Returns the program's instructions
+	 */
+	std::vector<instruction> &get_program(void) { return program; }
+
+	/*
+	 * Recomputes the maximum number of values held on the stack from the program's instructions
+	 */
+	void measure(void);
+
+	/*
+	 * Returns the number of instructions in the program
+	 */
+	size_t size(void) { return program.size(); }
+
+	/*
+	 * Returns a string representation of the program
+	 */
+	void to_string(std::string &str);
+};
+
+#endif
@@ -18,11 +18,15 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <cerrno>
+#include <climits>
 #include <cmath>
 #include <csignal>
 #include <cstdint>
 #include <cstdlib>
 #include <ctime>
+#include <fstream>
 #include <iostream>
 #include <set>
 #include "calc.hpp"
@@ -42,29 +46,38 @@ const std::string calc::HELP_INFO_DATA[calc::HELP_INFO_DATA_SIZE] = {
 	"acos -- arc cosine",
 	"asin -- arc sine",
 	"atan -- arc tangent",
+	"base [2|8|10|16] -- set the integer output radix (input with 0b, 0o, 0x)",
 	"ceiling -- ceiling (maintains type)",
 	"constants: e, pi",
 	"cos -- cosine",
 	"cosh -- hyperbolic cosine",
+	"digits -- number of digits of an integer (in the output radix)",
+	"expression > file -- write results to a file",
 	"fact [n] -- factorial",
+	"fast [on|off] -- toggle hardware (double-precision) floating-point",
 	"fib [n] -- fibonacci sequence",
 	"float -- cast to floating-point",
 	"floor -- floor (maintains type)",
 	"int -- cast to integer",
+	"limit [digits] -- summarize results longer than a number of digits (0 for unlimited)",
 	"ln -- natural log (log-base-e)",
 	"log2 -- log-base-2",
 	"log10 -- log-base-10",
 	"make -- assign an id to an expression",
+	"precision [bits] -- set the floating-point working precision",
 	"rand -- normalized random numbers (0-1)",
 	"reset -- resets the global state",
 	"round -- round to nearest integer (maintains type)",
+	"seed [n] -- reseed the random number generator",
 	"sin -- sine",
 	"sinh -- hyperbolic sine",
 	"sqr -- square",
 	"sqrt -- square root",
 	"state -- prints the global state",
+	"stats -- prints memory allocation statistics",
 	"tan -- tangent",
 	"tanh -- hyperbolic tangent",
+	"threads [n] -- set the number of worker threads for large integers",
 };
 
 /*
@@ -80,7 +93,7 @@ const std::string calc::PROMPT(">> ");
 /*
  * Version number
  */
-const std::string calc::VERSION("Cli-Calculator 0.1.2");
+const std::string calc::VERSION("Cli-Calculator 0.1.3");
 
 /*
  * Warranty statement
@@ -90,14 +103,26 @@ const std::string calc::WARRANTY("This is free software. There is NO warranty.")
 /*
  * Built-in commands
  */
-const std::string calc::CMD_DATA[5] = { "about", "exit", "help", "reset", "state" };
-const std::set<std::string> calc::CMD_SET(CMD_DATA, CMD_DATA + 5);
+const std::string calc::CMD_DATA[12] = { "about", "base", "exit", "fast", "help", "limit", "precision", "reset", "seed", "state", "stats",
+		"threads" };
+const std::set<std::string> calc::CMD_SET(CMD_DATA, CMD_DATA + 12);
 
 /*
  * Command-line commands
  */
-const std::string calc::C_CMD_DATA[3] = { "--help", "--version" };
-const std::set<std::string> calc::C_CMD_SET(C_CMD_DATA, C_CMD_DATA + 2);
+const std::string calc::C_CMD_DATA[9] = { "--base", "--fast", "--help", "--limit", "--max-mem", "--precision", "--seed",
+		"--threads", "--version" };
+const std::set<std::string> calc::C_CMD_SET(C_CMD_DATA, C_CMD_DATA + 9);
+
+/*
+ * Constants cached at the working precision
+ */
+std::map<std::string, num_value> calc::constant_cache;
+
+/*
+ * Session random number generator (seeded in main, once libgmp's memory functions are installed)
+ */
+rand_gen calc::generator;
 
 /*
  * Checks input for commands prior to evaluation
@@ -118,584 +143,846 @@ int calc::check_input(std::string &input, sym_table &state) {
 		if(commands.at(0) == calc::CMD_DATA[calc::ABOUT])
 			std::cout << calc::VERSION << " -- " << calc::COPYRIGHT << std::endl << calc::WARRANTY << std::endl;
 
+		// set integer output radix
+		else if(commands.at(0) == calc::CMD_DATA[calc::BASE]) {
+			if(commands.size() > 1
+					&& !calc::set_base(commands.at(1)))
+				std::cerr << "Invalid base: " << commands.at(1) << std::endl;
+			std::cout << "Base: " << num_value::get_base() << std::endl;
+		}
+
 		// exit interactive mode
 		else if(commands.at(0) == calc::CMD_DATA[calc::EXIT])
 			return exc_code::EXIT;
 
+		// toggle hardware floating-point mode
+		else if(commands.at(0) == calc::CMD_DATA[calc::FAST]) {
+			bool fast = num_value::get_mode() != num_value::HARDWARE;
+			if(commands.size() > 1)
+				fast = commands.at(1) == "on";
+			num_value::set_mode(fast ? num_value::HARDWARE : num_value::MULTI_PRECISION);
+			std::cout << "Fast mode: " << (fast ? "on" : "off") << std::endl;
+		}
+
 		// display help information
 		else if(commands.at(0) == calc::CMD_DATA[calc::HELP])
 			for(unsigned int i = 0; i < calc::HELP_INFO_DATA_SIZE; i++)
 				std::cout << calc::HELP_INFO_DATA[i] << std::endl;
 
+		// set display limit
+		else if(commands.at(0) == calc::CMD_DATA[calc::LIMIT]) {
+			if(commands.size() > 1
+					&& !calc::set_limit(commands.at(1)))
+				std::cerr << "Invalid limit: " << commands.at(1) << std::endl;
+			std::cout << "Limit: " << num_value::get_limit() << " digits" << std::endl;
+		}
+
+		// set floating-point working precision
+		else if(commands.at(0) == calc::CMD_DATA[calc::PRECISION]) {
+			if(commands.size() > 1
+					&& !calc::set_precision(commands.at(1)))
+				std::cerr << "Invalid precision: " << commands.at(1) << std::endl;
+			std::cout << "Precision: " << num_value::get_precision() << " bits (" << num_value::get_digits() << " digits)" << std::endl;
+		}
+
 		// reset global state
-		else if(commands.at(0) == calc::CMD_DATA[calc::RESET])
+		else if(commands.at(0) == calc::CMD_DATA[calc::RESET]) {
 			state.cleanup();
+			sym_table::clear_ids();
+			calc::clear_constants();
+		}
+
+		// reseed random number generator
+		else if(commands.at(0) == calc::CMD_DATA[calc::SEED]) {
+			if(commands.size() > 1
+					&& !calc::set_seed(commands.at(1)))
+				std::cerr << "Invalid seed: " << commands.at(1) << std::endl;
+			std::cout << "Seed: " << calc::generator.get_seed() << std::endl;
+		}
 
 		// diplay global state
 		else if(commands.at(0) == calc::CMD_DATA[calc::STATE]) {
 			state.to_string(str);
 			std::cout << str;
 
+		// display memory allocation statistics
+		} else if(commands.at(0) == calc::CMD_DATA[calc::STATS]) {
+			std::cout << "Allocations: " << reg_pool::get_allocations() << ", Frees: " << reg_pool::get_frees() << std::endl;
+			std::cout << "Registers initialized: " << reg_pool::get_initialized() << ", Reused: " << reg_pool::get_reused() << std::endl;
+			std::cout << "Memory: " << reg_pool::get_usage() << " bytes, Pooled: " << reg_pool::get_pooled() << " bytes, Peak: "
+					<< reg_pool::get_peak() << " bytes, Limit: ";
+			if(reg_pool::get_limit())
+				std::cout << reg_pool::get_limit() << " bytes" << std::endl;
+			else
+				std::cout << "none" << std::endl;
+
+		// set number of worker threads
+		} else if(commands.at(0) == calc::CMD_DATA[calc::THREADS]) {
+			if(commands.size() > 1
+					&& !calc::set_threads(commands.at(1)))
+				std::cerr << "Invalid threads: " << commands.at(1) << std::endl;
+			std::cout << "Threads: " << par_int::get_threads() << std::endl;
+
 		// unknown command
 		} else
 			std::cerr << "Unknown command: " << commands.at(0) << std::endl;
 
-	// evaluate input
+	// evaluate input, writing results to a file if redirected
+	} else if(calc::get_redirect(input, str)) {
+		std::ofstream file(str.c_str(), std::ios::out | std::ios::trunc);
+		if(!file.is_open()) {
+			std::cerr << "Unable to open file: " << str << std::endl;
+			return exc_code::SUCCESS;
+		}
+		return calc::eval_input(input, state, file);
 	} else
-		return calc::eval_input(input, state);
+		return calc::eval_input(input, state, std::cout);
 	return exc_code::SUCCESS;
 }
 
 /*
- * Convert mpfr_t to string
+ * Release cached constants
  */
-bool calc::convert_to_string(mpfr_t &value, const unsigned int precision, std::string &output) {
-	char *tmp = NULL;
-	mp_exp_t dec_pos;
+void calc::clear_constants(void) {
 
-	// convert to a string
-	tmp = mpfr_get_str(tmp, &dec_pos, 10, precision, value, GMP_RNDN);
-	if(!tmp)
-		return false;
-	else {
-		output.assign(tmp);
-		if(dec_pos <= 0) {
-			if(output.at(0) == '-')
-				output.insert(1, "0.");
-			else
-				output.insert(0, "0.");
-		} else if((unsigned int) dec_pos < output.size())
-			output.insert(dec_pos, ".");
+	// release cached values, along with libmpfr's own constant cache
+	constant_cache.clear();
+	mpfr_free_cache();
+}
+
+/*
+ * Folds the constant operations of a program into literals (random numbers are never folded)
+ */
+void calc::fold_code(byte_code &code) {
+	size_t out = 0;
+	bool folding = true;
+	num_value accum, second;
+	std::vector<byte_code::instruction> &program = code.get_program();
+
+	// fold each instruction over the literals preceding it, a literal is always a complete operand
+	for(size_t i = 0; i < program.size(); i++) {
+		byte_code::instruction instr = program[i];
+		byte_code::instruction *last = out ? &program[out - 1] : NULL, *prev = (out > 1) ? &program[out - 2] : NULL;
+
+		// stop folding at the first failure, everything after it is never evaluated
+		if(folding)
+			try {
+				switch(instr.op) {
+
+					// evaluate a function of a literal
+					case byte_code::CALL:
+						if(last->op != byte_code::LITERAL)
+							break;
+						accum = code.get_literal(last->code);
+						eval_function(instr.code, accum);
+						code.get_literal(last->code).swap(accum);
+						continue;
+
+					// drop the check of a literal that is a number
+					case byte_code::CHECK:
+						if(last->op != byte_code::LITERAL)
+							break;
+						if(!code.get_literal(last->code).is_integer()
+								&& !code.get_literal(last->code).is_float())
+							throw exc_code::INVALID_OPERAND;
+						continue;
+
+					// evaluate a constant (other than a random number)
+					case byte_code::CONSTANT:
+						if(instr.code == lexer::RAND)
+							break;
+						eval_constant(instr.code, accum);
+						instr.op = byte_code::LITERAL;
+						instr.code = code.add_literal(accum);
+						break;
+
+					// nothing after a failure is folded
+					case byte_code::FAIL: folding = false;
+						break;
+
+					// negate a literal
+					case byte_code::NEGATE:
+						if(last->op != byte_code::LITERAL)
+							break;
+						code.get_literal(last->code).negate();
+						continue;
+
+					// evaluate an operation of two literals (the second literal is released)
+					case byte_code::OPER:
+						if(last->op != byte_code::LITERAL
+								|| !prev
+								|| prev->op != byte_code::LITERAL)
+							break;
+						accum = code.get_literal(prev->code);
+						second = code.get_literal(last->code);
+						eval_operator(instr.type, instr.code, accum, second);
+						code.get_literal(prev->code).swap(accum);
+						code.get_literal(last->code).clear();
+						out--;
+						continue;
+					default:
+						break;
+				}
+			} catch(int e) {
+				folding = false;
+			}
+		program[out++] = instr;
 	}
-	mpfr_free_str(tmp);
-	return true;
+	program.resize(out);
+	accum.clear();
+	second.clear();
 }
 
 /*
- * Evaluate a constant
+ * Fuses the chains of additions & multiplications in a program into sums & products of several terms
  */
-void calc::eval_constant(syn_tree &tree) {
-	token tok;
-	mpfr_t value;
-	std::string output;
-	mpfr_init(value);
+void calc::fuse_code(byte_code &code) {
+	size_t out = 0, second;
+	unsigned int first_terms, second_terms;
+	bool fused = false;
+	std::vector<size_t> starts;
+	std::vector<byte_code::instruction> &program = code.get_program();
+
+	// fuse each addition (or multiplication) with the sums (or products) ending its operands, noting where each
+	// operand starts
+	for(size_t i = 0; i < program.size(); i++) {
+		byte_code::instruction instr = program[i];
+		switch(instr.op) {
+
+			// operands start where they are pushed
+			case byte_code::CONSTANT:
+			case byte_code::FETCH:
+			case byte_code::LITERAL:
+			case byte_code::LOAD:
+			case byte_code::TAKE:
+				starts.push_back(out);
+				break;
 
-	// verify token is of type constant
-	tree.get_contents(tok);
-	if(tok.get_type() != token::CONSTANT)
-		throw exc_code::INVALID_CONSTANT;
+			// operation of two operands (the first operand's start is kept)
+			case byte_code::OPER:
+				second = starts.back();
+				starts.pop_back();
+				if(instr.type != token::OPER
+						|| (instr.code != lexer::MULTI
+						&& instr.code != lexer::PLUS))
+					break;
 
-	// evaluate as exp
-	if(tok.get_text() == lexer::CONSTANT_OPER_DATA[lexer::E]) {
-		mpfr_t one;
-		mpfr_init_set_ui(one, 1, GMP_RNDN);
-		mpfr_exp(value, one, GMP_RNDN);
-		mpfr_clear(one);
+				// hardware floats are added as written
+				if(instr.code == lexer::PLUS
+						&& num_value::get_mode() == num_value::HARDWARE)
+					break;
+				first_terms = get_terms(program[second - 1], instr.code);
+
+				// products are fused along their (right-nested) chain only, a parenthesized first operand
+				// keeps its grouping, as floats are multiplied in turn
+				if(instr.code == lexer::MULTI)
+					first_terms = 1;
+				second_terms = get_terms(program[out - 1], instr.code);
+				if(first_terms + second_terms < 3
+						|| first_terms + second_terms > FUSE_TERMS)
+					break;
+
+				// drop the sums (or products) ending either operand, their terms are fused into a single instruction
+				if(second_terms > 1)
+					out--;
+				if(first_terms > 1) {
+					std::copy(program.begin() + second, program.begin() + out, program.begin() + second - 1);
+					out--;
+				}
+				instr.op = (instr.code == lexer::PLUS) ? byte_code::SUM : byte_code::PRODUCT;
+				instr.code = first_terms + second_terms;
+				fused = true;
+				break;
+			default:
+				break;
+		}
+		program[out++] = instr;
 	}
+	program.resize(out);
 
-	// evaluate as pi
-	else if(tok.get_text() == lexer::CONSTANT_OPER_DATA[lexer::PI])
-		mpfr_const_pi(value, GMP_RNDN);
+	// sums & products hold all of their terms on the stack at once
+	if(fused)
+		code.measure();
+}
 
-	// evaluate as a random number between 0.0 - 1.0
-	else if(tok.get_text() == lexer::CONSTANT_OPER_DATA[lexer::RAND]) {
-		gmp_randstate_t rand_st;
-		gmp_randinit_mt(rand_st);
-		gmp_randseed_ui(rand_st, time(NULL));
-		mpfr_urandomb(value, rand_st);
-		gmp_randclear(rand_st);
+/*
+ * Rewrites the operations of a program into cheaper equivalents (squares, shifts & masks by powers of 2,
+ * casts through a float)
+ */
+void calc::reduce_code(byte_code &code) {
+	size_t out = 0, first, second;
+	std::vector<size_t> starts;
+	std::vector<byte_code::instruction> &program = code.get_program();
+
+	// rewrite each instruction over the operands preceding it, noting where each operand starts
+	for(size_t i = 0; i < program.size(); i++) {
+		byte_code::instruction instr = program[i];
+		byte_code::instruction *last = out ? &program[out - 1] : NULL;
+		switch(instr.op) {
+
+			// cast to an integer through a float in a single step
+			case byte_code::CALL:
+				if(instr.code != lexer::INT
+						|| last->op != byte_code::CALL
+						|| last->code != lexer::FLOAT)
+					break;
+				last->op = byte_code::ROUND;
+				last->code = 0;
+				continue;
+
+			// operands start where they are pushed
+			case byte_code::CONSTANT:
+			case byte_code::FETCH:
+			case byte_code::LITERAL:
+			case byte_code::LOAD:
+			case byte_code::TAKE:
+				starts.push_back(out);
+				break;
+
+			// operation of two operands (the first operand's start is kept)
+			case byte_code::OPER:
+				second = starts.back();
+				starts.pop_back();
+				first = starts.back();
+				if(instr.type != token::OPER)
+					break;
+
+				// square rather than raise to the power of 2 (the literal is released)
+				if(instr.code == lexer::POW
+						&& last->op == byte_code::LITERAL
+						&& code.get_literal(last->code).is_small()
+						&& code.get_literal(last->code).get_small() == 2) {
+					code.get_literal(last->code).clear();
+					last->op = byte_code::CALL;
+					last->code = lexer::SQR;
+					continue;
+				} else if(instr.code != lexer::MULTI
+						&& instr.code != lexer::DIV
+						&& instr.code != lexer::MOD)
+					break;
+
+				// multiply, divide or take the modulo by a second operand that is a power of 2
+				if(is_power2(code, *last)) {
+					last->op = byte_code::SHIFT;
+					last->type = instr.code;
+					continue;
+				}
+
+				// multiply by a first operand that is a power of 2, moving the literal after the second operand
+				if(instr.code == lexer::MULTI
+						&& second == first + 1
+						&& is_power2(code, program[first])) {
+					instr.op = byte_code::SHIFT;
+					instr.type = lexer::MULTI;
+					instr.code = program[first].code;
+					std::copy(program.begin() + second, program.begin() + out, program.begin() + first);
+					program[out - 1] = instr;
+					continue;
+				}
+				break;
+			default:
+				break;
+		}
+		program[out++] = instr;
 	}
+	program.resize(out);
+}
 
-	else
-		throw exc_code::INVALID_CONSTANT;
+/*
+ * Returns a non-negative integer operand as a count (shift, exponent, etc.)
+ */
+unsigned long calc::get_count(num_value &value) {
+
+	// truncate floating-point counts
+	if(value.is_hardware()) {
+		if(value.get_hardware() < 0)
+			throw exc_code::EXPECTING_POSITIVE_INTEGER_OPERAND;
+		if(!(value.get_hardware() < ULONG_MAX))
+			throw exc_code::INVALID_OPERAND;
+		return (unsigned long) value.get_hardware();
+	} else if(value.is_float()) {
+		if(mpfr_sgn(value.get_float()) < 0)
+			throw exc_code::EXPECTING_POSITIVE_INTEGER_OPERAND;
+		if(!mpfr_fits_ulong_p(value.get_float(), GMP_RNDZ))
+			throw exc_code::INVALID_OPERAND;
+		return mpfr_get_ui(value.get_float(), GMP_RNDZ);
+	}
 
-	// convert value to string
-	if(!convert_to_string(value, 0, output))
-		output = "0.0";
+	// check that the integer is in range
+	if(value.is_small()) {
+		if(value.get_small() < 0)
+			throw exc_code::EXPECTING_POSITIVE_INTEGER_OPERAND;
+		return value.get_small();
+	} else if(mpz_sgn(value.get_integer()) < 0)
+		throw exc_code::EXPECTING_POSITIVE_INTEGER_OPERAND;
+	if(!mpz_fits_ulong_p(value.get_integer()))
+		throw exc_code::INVALID_OPERAND;
+	return mpz_get_ui(value.get_integer());
+}
 
-	tree.set_text(output);
-	tree.set_type(token::FLOAT);
+/*
+ * Returns the base-2 logarithm of an integer's magnitude (0 for zero)
+ */
+double calc::get_log2(const mpz_t value) {
+	long exponent;
+	double mantissa = mpz_get_d_2exp(&exponent, value);
 
-	// cleanup
-	mpfr_clear(value);
-	mpfr_free_cache();
+	// value = mantissa * 2^exponent, with 0.5 <= |mantissa| < 1
+	if(!mpz_sgn(value))
+		return 0;
+	return exponent + std::log2(std::fabs(mantissa));
 }
 
 /*
- * Evaluate an expression
+ * Returns the number of terms an instruction adds or multiplies (1 unless it is an addition or sum, or a
+ * multiplication or product, as given by the operator)
  */
-void calc::eval_expression(syn_tree &tree, sym_table &state) {
-	token accum, child;
-	unsigned int type, size;
+unsigned int calc::get_terms(byte_code::instruction &instr, unsigned int oper) {
+
+	// sums & products hold their term count
+	if((instr.op == byte_code::SUM && oper == lexer::PLUS)
+			|| (instr.op == byte_code::PRODUCT && oper == lexer::MULTI))
+		return instr.code;
+	else if(instr.op == byte_code::OPER
+			&& instr.type == token::OPER
+			&& instr.code == oper)
+		return 2;
+	return 1;
+}
 
-	// verify token is of type expression
-	tree.get_type(type);
-	if(type != token::EXPRESSION)
-		throw exc_code::INVALID_EXPRESSION;
+/*
+ * Returns true if an instruction pushes a literal power of 2 held in a machine word
+ */
+bool calc::is_power2(byte_code &code, byte_code::instruction &instr) {
+	int64_t value;
 
-	// evaluate child tokens left to right
-	size = tree.get_size();
-	for(unsigned int i = 0; i < size; i++) {
-		tree.advance_forward(i);
-		tree.get_contents(child);
+	// check that the literal is a positive machine-word integer with a single bit set
+	if(instr.op != byte_code::LITERAL
+			|| !code.get_literal(instr.code).is_small())
+		return false;
+	value = code.get_literal(instr.code).get_small();
+	return value > 0
+			&& !(value & (value - 1));
+}
 
-		// evaluate first token
-		if(!i) {
-			switch(child.get_type()) {
+/*
+ * Evaluate a program over a stack of values (reused between programs) & slots of shared values, leaving its
+ * value in result
+ */
+void calc::eval_code(byte_code &code, sym_table &state, std::vector<num_value> &stack, std::vector<num_value> &slots,
+		num_value &result) {
+	size_t top = 0;
+	std::vector<byte_code::instruction> &program = code.get_program();
+	std::vector<byte_code::instruction>::iterator i = program.begin();
+
+	// make room for the deepest point of the program
+	if(stack.size() < code.get_depth())
+		stack.resize(code.get_depth());
+
+	// execute each instruction in turn
+	for(; i != program.end(); ++i)
+		switch(i->op) {
+
+			// evaluate as a function of the top value
+			case byte_code::CALL: eval_function(i->code, stack[top - 1]);
+				break;
 
-				// evaluate as a constant
-				case token::CONSTANT: eval_constant(tree);
-					break;
+			// check that the top value is a valid operand
+			case byte_code::CHECK:
+				if(!stack[top - 1].is_integer()
+						&& !stack[top - 1].is_float())
+					throw exc_code::INVALID_OPERAND;
+				break;
 
-				// evaluate as an expression
-				case token::EXPRESSION: eval_expression(tree, state);
-					break;
+			// push a constant
+			case byte_code::CONSTANT: eval_constant(i->code, stack[top++]);
+				break;
 
-				// evaluate as a function
-				case token::FUNCTION: eval_function(tree, state);
-					break;
+			// fail at this point of the evaluation
+			case byte_code::FAIL: throw (int) i->code;
+				break;
 
-				// evaluate as a string
-				case token::STRING:
-					if(!state.get_value(child.get_text(), accum))
-						throw exc_code::UNDEFINED_IDENTIFIER;
-					tree.set_contents(accum);
-					break;
+			// push a copy of a shared value
+			case byte_code::FETCH: stack[top++] = slots[i->code];
+				break;
 
-				// evaluate as a unary operator
-				case token::UNARY_OPER:
-					if(child.get_text() == lexer::UNARY_OPER_DATA[lexer::NOT]) {
-						tree.advance_forward(i);
-						eval_expression(tree, state);
-						tree.negate();
-						tree.get_contents(accum);
-						tree.advance_back();
-						tree.set_contents(accum);
-					} else
-						throw exc_code::INVALID_UNARY_OPERATOR;
-					break;
-				default:
-					if(child.get_type() != token::INTEGER
-							&& child.get_type() != token::FLOAT)
-						throw exc_code::INVALID_EXPRESSION;
+			// push a literal
+			case byte_code::LITERAL: stack[top++] = code.get_literal(i->code);
+				break;
+
+			// push the value of an identifier
+			case byte_code::LOAD:
+				if(!state.get_value(i->code, stack[top++]))
+					throw exc_code::UNDEFINED_IDENTIFIER;
+				break;
+
+			// negate the top value (if possible)
+			case byte_code::NEGATE: stack[top - 1].negate();
+				break;
+
+			// evaluate as an operation of the top two values (releasing the second)
+			case byte_code::OPER:
+				top--;
+				eval_operator(i->type, i->code, stack[top - 1], stack[top]);
+				stack[top].clear();
+				break;
+
+			// cast the top value to an integer through a float (integers held exactly by a float are unchanged)
+			case byte_code::ROUND:
+				if(!stack[top - 1].fits_float()) {
+					eval_function(lexer::FLOAT, stack[top - 1]);
+					eval_function(lexer::INT, stack[top - 1]);
+				}
+				break;
+
+			// evaluate as an operation of the top value by a literal power of 2 (shifting or masking integers)
+			case byte_code::SHIFT:
+				if(eval_shift(i->type, stack[top - 1], code.get_literal(i->code)))
 					break;
-			}
-			tree.get_contents(accum);
-
-		// evaluate second token
-		} else {
-			if(tree.get_size() != 1
-					|| (child.get_type() != token::BINARY_OPER
-					&& child.get_type() != token::LOGICAL_OPER
-					&& child.get_type() != token::OPER))
-				throw exc_code::INVALID_EXPRESSION;
+				else if(!stack[top - 1].is_float())
+					throw exc_code::INVALID_OPERAND;
+				stack[top] = code.get_literal(i->code);
+				eval_operator(token::OPER, i->type, stack[top - 1], stack[top]);
+				stack[top].clear();
+				break;
+
+			// store a copy of the top value to be shared
+			case byte_code::STORE: slots[i->code] = stack[top - 1];
+				break;
 
-			// evaluate as an operation
-			eval_operator(tree, accum, state);
+			// evaluate as a sum of the top values (releasing all but the first)
+			case byte_code::SUM:
+				top -= i->code - 1;
+				eval_sum(&stack[top - 1], i->code);
+				break;
+
+			// evaluate as a product of the top values (releasing all but the first)
+			case byte_code::PRODUCT:
+				top -= i->code - 1;
+				eval_product(&stack[top - 1], i->code);
+				break;
+
+			// push a shared value on its last use (without copying)
+			case byte_code::TAKE:
+				stack[top++].swap(slots[i->code]);
+				slots[i->code].clear();
+				break;
+			default:
+				throw exc_code::INVALID_EXPRESSION;
+				break;
 		}
 
-		// set the contents of the accumulator token (root)
-		tree.advance_back();
-		tree.set_contents(accum);
-	}
+	// take the value left on the stack (without copying)
+	if(top != 1)
+		throw exc_code::INVALID_EXPRESSION;
+	result.swap(stack[0]);
+	stack[0].clear();
 }
 
 /*
- * Evaluate a function
+ * Evaluate a constant
  */
-void calc::eval_function(syn_tree &tree, sym_table &state) {
-	token tok, child;
-	unsigned int type;
-	std::string text, output;
+void calc::eval_constant(unsigned int code, num_value &result) {
+
+	// evaluate in hardware
+	if(num_value::get_mode() == num_value::HARDWARE
+			&& code != lexer::RAND) {
+		if(code == lexer::E)
+			result.set_hardware(M_E);
+		else if(code == lexer::PI)
+			result.set_hardware(M_PI);
+		else
+			throw exc_code::INVALID_CONSTANT;
+	}
 
-	// verify token is of type function
-	tree.get_type(type);
-	if(type != token::FUNCTION
-			|| tree.get_size() != 1)
-		throw exc_code::INVALID_FUNCTION;
+	// evaluate as exp or pi, computed once per working precision
+	else if(code == lexer::E
+			|| code == lexer::PI) {
+		num_value &cached = calc::constant_cache[lexer::CONSTANT_OPER_DATA[code]];
+		if(!cached.is_float()) {
+			mpfr_t &cached_value = cached.set_float();
+			if(code == lexer::E) {
+				mpfr_set_ui(cached_value, 1, GMP_RNDN);
+				mpfr_exp(cached_value, cached_value, GMP_RNDN);
+			} else
+				mpfr_const_pi(cached_value, GMP_RNDN);
+		}
+		mpfr_t &value = result.set_float();
+		mpfr_set(value, cached.get_float(), GMP_RNDN);
+	}
 
-	// Retrieve child value
-	tree.get_text(text);
-	tree.advance_forward(0);
-	eval_expression(tree, state);
-	tree.get_contents(child);
-	tree.advance_back();
+	// evaluate as a random number between 0.0 - 1.0
+	else if(code == lexer::RAND)
+		calc::generator.next(result);
+
+	else
+		throw exc_code::INVALID_CONSTANT;
+}
+
+/*
+ * Evaluate a function over a value
+ */
+void calc::eval_function(unsigned int code, num_value &child) {
+	int64_t result;
 
 	// check that child type is valid
-	if(child.get_type() != token::INTEGER
-			&& child.get_type() != token::FLOAT)
+	if(!child.is_integer()
+			&& !child.is_float())
 		throw exc_code::INVALID_FUNCTION;
-	tree.set_type(token::FLOAT);
-
-	// execute abs function on input
-	if(text == lexer::FUNCTION_OPER_DATA[lexer::ABS]) {
-		if(child.get_type() == token::INTEGER) {
-			tree.set_type(token::INTEGER);
-			mpz_t value;
-			token::convert_to_integer(value, child.get_text());
-			mpz_abs(value, value);
-			token::convert_to_string(value, output);
-			mpz_clear(value);
-		} else {
-			mpf_t value;
-			token::convert_to_float(value, child.get_text());
-			mpf_abs(value, value);
-			token::convert_to_string(value, output);
-			mpf_clear(value);
-		}
 
-	// execute arc cos function on input
-	} else if(text == lexer::FUNCTION_OPER_DATA[lexer::ACOS]) {
-		mpfr_t value, input;
-		mpfr_init(value);
-		mpfr_init_set_str(input, child.get_text().c_str(), 10, GMP_RNDN);
-		mpfr_acos(value, input, GMP_RNDN);
-
-		// convert value to string
-		if(!convert_to_string(value, 0, output))
-			output = "0.0";
-		mpfr_clear(value);
-		mpfr_clear(input);
-
-	// execute arc sin function on input
-	} else if(text == lexer::FUNCTION_OPER_DATA[lexer::ASIN]) {
-		mpfr_t value, input;
-		mpfr_init(value);
-		mpfr_init_set_str(input, child.get_text().c_str(), 10, GMP_RNDN);
-		mpfr_asin(value, input, GMP_RNDN);
-
-		// convert value to string
-		if(!convert_to_string(value, 0, output))
-			output = "0.0";
-		mpfr_clear(value);
-		mpfr_clear(input);
-
-	// execute arc tan function on input
-	} else if(text == lexer::FUNCTION_OPER_DATA[lexer::ATAN]) {
-		mpfr_t value, input;
-		mpfr_init(value);
-		mpfr_init_set_str(input, child.get_text().c_str(), 10, GMP_RNDN);
-		mpfr_atan(value, input, GMP_RNDN);
-
-		// convert value to string
-		if(!convert_to_string(value, 0, output))
-			output = "0.0";
-		mpfr_clear(value);
-		mpfr_clear(input);
-
-	// execute ceiling function on input
-	} else if(text == lexer::FUNCTION_OPER_DATA[lexer::CEILING]) {
-		if(child.get_type() != token::INTEGER) {
-			mpz_t i_val;
-			mpf_t f_val;
-			mpz_init(i_val);
-			token::convert_to_float(f_val, child.get_text());
-			mpz_set_f(i_val, f_val);
-			mpf_set_z(f_val, i_val);
-			mpf_add_ui(f_val, f_val, 1);
-			token::convert_to_string(f_val, output);
-			mpz_clear(i_val);
-			mpf_clear(f_val);
-		} else {
-			tree.set_type(token::INTEGER);
-			output = child.get_text();
-		}
+	// evaluate based off function code
+	switch(code) {
+
+		// execute abs function on input
+		case lexer::ABS:
+			if(child.is_small()
+					&& child.get_small() != INT64_MIN)
+				child.set_small(child.get_small() < 0 ? -child.get_small() : child.get_small());
+			else if(child.is_hardware())
+				child.set_hardware(std::fabs(child.get_hardware()));
+			else if(child.is_integer())
+				mpz_abs(child.get_integer(), child.get_integer());
+			else
+				mpfr_abs(child.get_float(), child.get_float(), GMP_RNDN);
+			break;
 
-	// execute cos function on input
-	} else if(text == lexer::FUNCTION_OPER_DATA[lexer::COS]) {
-		mpfr_t value, input;
-		mpfr_init(value);
-		mpfr_init_set_str(input, child.get_text().c_str(), 10, GMP_RNDN);
-		mpfr_cos(value, input, GMP_RNDN);
-
-		// convert value to string
-		if(!convert_to_string(value, 0, output))
-			output = "0.0";
-		mpfr_clear(value);
-		mpfr_clear(input);
-
-	// execute hyperbolic cos function on input
-	} else if(text == lexer::FUNCTION_OPER_DATA[lexer::COSH]) {
-		mpfr_t value, input;
-		mpfr_init(value);
-		mpfr_init_set_str(input, child.get_text().c_str(), 10, GMP_RNDN);
-		mpfr_cosh(value, input, GMP_RNDN);
-
-		// convert value to string
-		if(!convert_to_string(value, 0, output))
-			output = "0.0";
-		mpfr_clear(value);
-		mpfr_clear(input);
-
-	// execute factorial function on input
-	} else if(text == lexer::FUNCTION_OPER_DATA[lexer::FACT]) {
-		if(child.get_type() == token::INTEGER) {
-			tree.set_type(token::INTEGER);
-			mpz_t value;
-			mpz_init(value);
-			uint64_t sec;
-			sec = token::convert_to<uint64_t>(child.get_text());
-			mpz_fac_ui(value, sec);
-			token::convert_to_string(value, output);
-			mpz_clear(value);
-		} else
-			throw exc_code::EXPECTING_INTEGER_OPERAND;
-
-	// execute fibonacci function on input
-	} else if(text == lexer::FUNCTION_OPER_DATA[lexer::FIB]) {
-		if(child.get_type() == token::INTEGER) {
-			tree.set_type(token::INTEGER);
-			mpz_t value;
-			mpz_init(value);
-			uint64_t sec;
-			sec = token::convert_to<uint64_t>(child.get_text());
-			mpz_fib_ui(value, sec);
-			token::convert_to_string(value, output);
-			mpz_clear(value);
-		} else
-			throw exc_code::EXPECTING_INTEGER_OPERAND;
-
-	// execute double cast function on input
-	} else if(text == lexer::FUNCTION_OPER_DATA[lexer::FLOAT]) {
-		output = child.get_text();
-
-	// execute floor function on input
-	} else if(text == lexer::FUNCTION_OPER_DATA[lexer::FLOOR]) {
-		if(child.get_type() != token::INTEGER) {
-			mpz_t i_val;
-			mpf_t f_val;
-			mpz_init(i_val);
-			token::convert_to_float(f_val, child.get_text());
-			mpz_set_f(i_val, f_val);
-			mpf_set_z(f_val, i_val);
-			token::convert_to_string(f_val, output);
-			mpz_clear(i_val);
-			mpf_clear(f_val);
-		} else {
-			tree.set_type(token::INTEGER);
-			output = child.get_text();
-		}
+		// execute arc cos function on input
+		case lexer::ACOS:
+			child.to_float();
+			if(!eval_hardware(child, std::acos))
+				mpfr_acos(child.get_float(), child.get_float(), GMP_RNDN);
+			break;
 
-	// execute integer cast function on input
-	} else if(text == lexer::FUNCTION_OPER_DATA[lexer::INT]) {
-		if(child.get_type() != token::INTEGER) {
-			tree.set_type(token::INTEGER);
-			mpz_t i_val;
-			mpf_t f_val;
-			mpz_init(i_val);
-			token::convert_to_float(f_val, child.get_text());
-			mpz_set_f(i_val, f_val);
-			token::convert_to_string(i_val, output);
-			mpz_clear(i_val);
-			mpf_clear(f_val);
-		} else {
-			tree.set_type(token::INTEGER);
-			output = child.get_text();
-		}
+		// execute arc sin function on input
+		case lexer::ASIN:
+			child.to_float();
+			if(!eval_hardware(child, std::asin))
+				mpfr_asin(child.get_float(), child.get_float(), GMP_RNDN);
+			break;
 
-	// execute natural log function on input
-	} else if(text == lexer::FUNCTION_OPER_DATA[lexer::LN]) {
-		mpfr_t value, input;
-		mpfr_init(value);
-		mpfr_init_set_str(input, child.get_text().c_str(), 10, GMP_RNDN);
-		mpfr_log(value, input, GMP_RNDN);
-
-		// convert value to string
-		if(!convert_to_string(value, 0, output))
-			output = "0.0";
-		mpfr_clear(value);
-		mpfr_clear(input);
-
-	// execute log(base 2) function on input
-	} else if(text == lexer::FUNCTION_OPER_DATA[lexer::LOG2]) {
-		mpfr_t value, input;
-		mpfr_init(value);
-		mpfr_init_set_str(input, child.get_text().c_str(), 10, GMP_RNDN);
-		mpfr_log2(value, input, GMP_RNDN);
-
-		// convert value to string
-		if(!convert_to_string(value, 0, output))
-			output = "0.0";
-		mpfr_clear(value);
-		mpfr_clear(input);
-
-	// execute log(base 10) function on input
-	} else if(text == lexer::FUNCTION_OPER_DATA[lexer::LOG10]) {
-		mpfr_t value, input;
-		mpfr_init(value);
-		mpfr_init_set_str(input, child.get_text().c_str(), 10, GMP_RNDN);
-		mpfr_log10(value, input, GMP_RNDN);
-
-		// convert value to string
-		if(!convert_to_string(value, 0, output))
-			output = "0.0";
-		mpfr_clear(value);
-		mpfr_clear(input);
-
-	// execute round function on input
-	} else if(text == lexer::FUNCTION_OPER_DATA[lexer::ROUND]) {
-		if(child.get_type() != token::INTEGER) {
-			mpz_t floor;
-			mpf_t f_diff, f_floor;
-			mpz_init(floor);
-			mpf_init(f_floor);
-			token::convert_to_float(f_diff, child.get_text());
-			mpz_set_f(floor, f_diff);
-			mpf_set_z(f_floor, floor);
-			mpf_sub(f_diff, f_diff, f_floor);
-			if(mpf_cmp_d(f_diff, 0.5) >= 0)
-				mpf_add_ui(f_floor, f_floor, 1);
-			token::convert_to_string(f_floor, output);
-			mpz_clear(floor);
-			mpf_clear(f_diff);
-			mpf_clear(f_floor);
-		} else {
-			tree.set_type(token::INTEGER);
-			output = child.get_text();
-		}
+		// execute arc tan function on input
+		case lexer::ATAN:
+			child.to_float();
+			if(!eval_hardware(child, std::atan))
+				mpfr_atan(child.get_float(), child.get_float(), GMP_RNDN);
+			break;
 
-	// execute sin function on input
-	} else if(text == lexer::FUNCTION_OPER_DATA[lexer::SIN]) {
-		mpfr_t value, input;
-		mpfr_init(value);
-		mpfr_init_set_str(input, child.get_text().c_str(), 10, GMP_RNDN);
-		mpfr_sin(value, input, GMP_RNDN);
-
-		// convert value to string
-		if(!convert_to_string(value, 0, output))
-			output = "0.0";
-		mpfr_clear(value);
-		mpfr_clear(input);
-
-	// execute hyperbolic sin function on input
-	} else if(text == lexer::FUNCTION_OPER_DATA[lexer::SINH]) {
-		mpfr_t value, input;
-		mpfr_init(value);
-		mpfr_init_set_str(input, child.get_text().c_str(), 10, GMP_RNDN);
-		mpfr_sinh(value, input, GMP_RNDN);
-
-		// convert value to string
-		if(!convert_to_string(value, 0, output))
-			output = "0.0";
-		mpfr_clear(value);
-		mpfr_clear(input);
-
-	// execute square function on input
-	} else if(text == lexer::FUNCTION_OPER_DATA[lexer::SQR]) {
-		if(child.get_type() == token::INTEGER) {
-			tree.set_type(token::INTEGER);
-			mpz_t value;
-			token::convert_to_integer(value, child.get_text());
-			mpz_mul(value, value, value);
-			token::convert_to_string(value, output);
-			mpz_clear(value);
-		} else {
-			mpf_t value;
-			token::convert_to_float(value, child.get_text());
-			mpf_mul(value, value, value);
-			token::convert_to_string(value, output);
-			mpf_clear(value);
-		}
+		// execute ceiling function on input
+		case lexer::CEILING:
+			if(child.is_hardware())
+				child.set_hardware(std::trunc(child.get_hardware()) + 1);
+			else if(child.is_float()) {
+				mpfr_trunc(child.get_float(), child.get_float());
+				mpfr_add_ui(child.get_float(), child.get_float(), 1, GMP_RNDN);
+			}
+			break;
 
-	// execute sqrt function on input
-	} else if(text == lexer::FUNCTION_OPER_DATA[lexer::SQRT]) {
-		mpf_t value;
-		token::convert_to_float(value, child.get_text());
-		mpf_sqrt(value, value);
-		token::convert_to_string(value, output);
-		mpf_clear(value);
-
-	// execute tan function on input
-	} else if(text == lexer::FUNCTION_OPER_DATA[lexer::TAN]) {
-		mpfr_t value, input;
-		mpfr_init(value);
-		mpfr_init_set_str(input, child.get_text().c_str(), 10, GMP_RNDN);
-		mpfr_tan(value, input, GMP_RNDN);
-
-		// convert value to string
-		if(!convert_to_string(value, 0, output))
-			output = "0.0";
-		mpfr_clear(value);
-		mpfr_clear(input);
-
-	// execute hyperbolic tan function on input
-	} else if(text == lexer::FUNCTION_OPER_DATA[lexer::TANH]) {
-		mpfr_t value, input;
-		mpfr_init(value);
-		mpfr_init_set_str(input, child.get_text().c_str(), 10, GMP_RNDN);
-		mpfr_tanh(value, input, GMP_RNDN);
-
-		// convert value to string
-		if(!convert_to_string(value, 0, output))
-			output = "0.0";
-		mpfr_clear(value);
-		mpfr_clear(input);
+		// execute cos function on input
+		case lexer::COS:
+			child.to_float();
+			if(!eval_hardware(child, std::cos))
+				mpfr_cos(child.get_float(), child.get_float(), GMP_RNDN);
+			break;
 
-	} else
-		throw exc_code::INVALID_FUNCTION;
-	tree.set_text(output);
+		// execute hyperbolic cos function on input
+		case lexer::COSH:
+			child.to_float();
+			if(!eval_hardware(child, std::cosh))
+				mpfr_cosh(child.get_float(), child.get_float(), GMP_RNDN);
+			break;
+
+		// execute digit count function on input
+		case lexer::DIGITS:
+			if(child.is_integer())
+				child.set_small(child.get_length());
+			else
+				throw exc_code::EXPECTING_INTEGER_OPERAND;
+			break;
+
+		// execute factorial function on input
+		case lexer::FACT:
+			if(child.is_integer()) {
+				unsigned long count = get_count(child);
+				// stirling: log2(n!) ~ n * (log2(n) - log2(e)), log2(e) > 1.4426
+				if(count > 1)
+					reserve(count * (std::log2(count) - 1.4426));
+				par_int::fac(child.get_integer(), count);
+			} else
+				throw exc_code::EXPECTING_INTEGER_OPERAND;
+			break;
+
+		// execute fibonacci function on input
+		case lexer::FIB:
+			if(child.is_integer()) {
+				unsigned long count = get_count(child);
+				// fib(n) ~ phi^n, log2(phi) < 0.6943
+				reserve(count * 0.6943);
+				mpz_fib_ui(child.get_integer(), count);
+			} else
+				throw exc_code::EXPECTING_INTEGER_OPERAND;
+			break;
+
+		// execute double cast function on input
+		case lexer::FLOAT:
+			child.to_float();
+			break;
+
+		// execute floor function on input
+		case lexer::FLOOR:
+			if(child.is_hardware())
+				child.set_hardware(std::trunc(child.get_hardware()));
+			else if(child.is_float())
+				mpfr_trunc(child.get_float(), child.get_float());
+			break;
+
+		// execute integer cast function on input
+		case lexer::INT:
+			if(child.is_hardware()
+					&& std::fabs(child.get_hardware()) < INT64_MAX)
+				child.set_small((int64_t) child.get_hardware());
+			else if(child.is_float()) {
+				num_value value;
+				mpfr_get_z(value.set_integer(), child.get_float(), GMP_RNDZ);
+				child.swap(value);
+			}
+			break;
+
+		// execute natural log function on input
+		case lexer::LN:
+			child.to_float();
+			if(!eval_hardware(child, std::log))
+				mpfr_log(child.get_float(), child.get_float(), GMP_RNDN);
+			break;
+
+		// execute log(base 2) function on input
+		case lexer::LOG2:
+			child.to_float();
+			if(!eval_hardware(child, std::log2))
+				mpfr_log2(child.get_float(), child.get_float(), GMP_RNDN);
+			break;
+
+		// execute log(base 10) function on input
+		case lexer::LOG10:
+			child.to_float();
+			if(!eval_hardware(child, std::log10))
+				mpfr_log10(child.get_float(), child.get_float(), GMP_RNDN);
+			break;
+
+		// execute round function on input
+		case lexer::ROUND:
+			if(child.is_hardware()) {
+				double floor = std::trunc(child.get_hardware());
+				child.set_hardware((child.get_hardware() - floor >= 0.5) ? floor + 1 : floor);
+			} else if(child.is_float()) {
+				mpfr_t floor;
+				reg_pool::acquire(floor, num_value::get_precision());
+				mpfr_trunc(floor, child.get_float());
+				mpfr_sub(child.get_float(), child.get_float(), floor, GMP_RNDN);
+				if(mpfr_cmp_d(child.get_float(), 0.5) >= 0)
+					mpfr_add_ui(floor, floor, 1, GMP_RNDN);
+				mpfr_swap(child.get_float(), floor);
+				reg_pool::release(floor);
+			}
+			break;
+
+		// execute sin function on input
+		case lexer::SIN:
+			child.to_float();
+			if(!eval_hardware(child, std::sin))
+				mpfr_sin(child.get_float(), child.get_float(), GMP_RNDN);
+			break;
+
+		// execute hyperbolic sin function on input
+		case lexer::SINH:
+			child.to_float();
+			if(!eval_hardware(child, std::sinh))
+				mpfr_sinh(child.get_float(), child.get_float(), GMP_RNDN);
+			break;
+
+		// execute square function on input
+		case lexer::SQR:
+			if(child.is_small()
+					&& !__builtin_mul_overflow(child.get_small(), child.get_small(), &result))
+				child.set_small(result);
+			else if(child.is_integer()) {
+				reserve(2 * get_log2(child.get_integer()));
+				par_int::mul(child.get_integer(), child.get_integer(), child.get_integer());
+			} else if(!eval_hardware(child, sqr_hardware))
+				mpfr_sqr(child.get_float(), child.get_float(), GMP_RNDN);
+			break;
+
+		// execute sqrt function on input
+		case lexer::SQRT:
+			child.to_float();
+			if(!eval_hardware(child, std::sqrt))
+				mpfr_sqrt(child.get_float(), child.get_float(), GMP_RNDN);
+			break;
+
+		// execute tan function on input
+		case lexer::TAN:
+			child.to_float();
+			if(!eval_hardware(child, std::tan))
+				mpfr_tan(child.get_float(), child.get_float(), GMP_RNDN);
+			break;
+
+		// execute hyperbolic tan function on input
+		case lexer::TANH:
+			child.to_float();
+			if(!eval_hardware(child, std::tanh))
+				mpfr_tanh(child.get_float(), child.get_float(), GMP_RNDN);
+			break;
+		default:
+			throw exc_code::INVALID_FUNCTION;
+			break;
+	}
+	child.demote();
 }
 
 /*
- * Evaluate an operator
+ * Evaluate an operator over an accumulator & second operand
  */
-void calc::eval_operator(syn_tree &tree, token &accum, sym_table &state) {
-	unsigned int type;
-	token second, oper;
-	std::string output;
-
-	// check to make sure accum is a valid type
-	if(accum.get_type() != token::INTEGER
-			&& accum.get_type() != token::FLOAT)
-		throw exc_code::INVALID_OPERAND;
-
-	// retrieve second operand & operator
-	tree.get_contents(oper);
-	tree.advance_forward(0);
-	eval_expression(tree, state);
-	tree.get_contents(second);
-	tree.advance_back();
+void calc::eval_operator(unsigned int type, unsigned int oper, num_value &accum, num_value &second) {
+	unsigned long count;
 
 	// check to make sure second is a valid type
-	if(second.get_type() != token::INTEGER
-			&& second.get_type() != token::FLOAT)
+	if(!second.is_integer()
+			&& !second.is_float())
 		throw exc_code::INVALID_OPERAND;
 
-	// determine type
-	type = token::INTEGER;
-	if(accum.get_type() != token::INTEGER
-			|| second.get_type() != token::INTEGER)
-		type = token::FLOAT;
+	// evaluate machine-word integers directly, unless the operation overflows
+	if(accum.is_small()
+			&& second.is_small()
+			&& eval_small(type, oper, accum, second))
+		return;
 
 	// evaluate based off operator type
-	switch(oper.get_type()) {
+	switch(type) {
 
 		// evaluate as a binary operator
 		case token::BINARY_OPER:
 
 			// check for correct type
-			if(type == token::INTEGER) {
-				mpz_t value, sec;
-				token::convert_to_integer(value, accum.get_text());
-				token::convert_to_integer(sec, second.get_text());
-
-				// evaluate as a binary and
-				if(oper.get_text() == lexer::BINARY_OPER_DATA[lexer::AND])
-					mpz_and(value, value, sec);
-
-				// evaluate as a binary or
-				else if(oper.get_text() == lexer::BINARY_OPER_DATA[lexer::OR])
-					mpz_ior(value, value, sec);
-
-				// evaluate as a binary xor
-				else if(oper.get_text() == lexer::BINARY_OPER_DATA[lexer::XOR])
-					mpz_xor(value, value, sec);
-
-				else
-					throw exc_code::INVALID_BINARY_OPERATOR;
-				token::convert_to_string(value, output);
-				mpz_clear(value);
-				mpz_clear(sec);
+			if(accum.is_integer()
+					&& second.is_integer()) {
+				mpz_t &value = accum.get_integer(), &sec = second.get_integer();
+				switch(oper) {
+
+					// evaluate as a binary and
+					case lexer::AND: mpz_and(value, value, sec);
+						break;
+
+					// evaluate as a binary or
+					case lexer::OR: mpz_ior(value, value, sec);
+						break;
+
+					// evaluate as a binary xor
+					case lexer::XOR: mpz_xor(value, value, sec);
+						break;
+					default:
+						throw exc_code::INVALID_BINARY_OPERATOR;
+						break;
+				}
+				accum.demote();
 			} else
 				throw exc_code::EXPECTING_INTEGER_OPERAND;
 			break;
@@ -704,24 +991,26 @@ void calc::eval_operator(syn_tree &tree, token &accum, sym_table &state) {
 		case token::LOGICAL_OPER:
 
 			// check for correct type
-			if(type == token::INTEGER) {
-				mpz_t value;
-				uint64_t sec;
-				token::convert_to_integer(value, accum.get_text());
-				sec = token::convert_to<uint64_t>(second.get_text());
-
-				// evaluate as a logical left shift
-				if(oper.get_text() == lexer::LOGICAL_OPER_DATA[lexer::LEFT_SHIFT])
-					mpz_mul_2exp(value, value, sec);
-
-				// evaluate as a logical right shift
-				else if(oper.get_text() == lexer::LOGICAL_OPER_DATA[lexer::RIGHT_SHIFT]) {
-					mpz_tdiv_q_2exp(value, value, sec);
-
-				} else
-					throw exc_code::INVALID_LOGICAL_OPERATOR;
-				token::convert_to_string(value, output);
-				mpz_clear(value);
+			if(accum.is_integer()
+					&& second.is_integer()) {
+				mpz_t &value = accum.get_integer();
+				switch(oper) {
+
+					// evaluate as a logical left shift
+					case lexer::LEFT_SHIFT:
+						count = get_count(second);
+						reserve(get_log2(value) + count);
+						mpz_mul_2exp(value, value, count);
+						break;
+
+					// evaluate as a logical right shift
+					case lexer::RIGHT_SHIFT: mpz_tdiv_q_2exp(value, value, get_count(second));
+						break;
+					default:
+						throw exc_code::INVALID_LOGICAL_OPERATOR;
+						break;
+				}
+				accum.demote();
 			} else
 				throw exc_code::EXPECTING_INTEGER_OPERAND;
 			break;
@@ -730,98 +1019,428 @@ void calc::eval_operator(syn_tree &tree, token &accum, sym_table &state) {
 		case token::OPER:
 
 			// evaluate integer values
-			if(type == token::INTEGER) {
-				mpz_t value, sec;
-				token::convert_to_integer(value, accum.get_text());
-				token::convert_to_integer(sec, second.get_text());
-
-				// evaluate as a arithmetic plus
-				if(oper.get_text() == lexer::OPER_DATA[lexer::PLUS])
-					mpz_add(value, value, sec);
-
-				// evaluate as a arithmetic minus
-				else if(oper.get_text() == lexer::OPER_DATA[lexer::MINUS])
-					mpz_sub(value, value, sec);
-
-				// evaluate as a arithmetic multiply
-				else if(oper.get_text() == lexer::OPER_DATA[lexer::MULTI])
-					mpz_mul(value, value, sec);
-
-				// evaluate as a arithmetic divide
-				else if(oper.get_text() == lexer::OPER_DATA[lexer::DIV])
-					mpz_div(value, value, sec);
-
-				// evaluate as a arithmetic modulo
-				else if(oper.get_text() == lexer::OPER_DATA[lexer::MOD])
-					mpz_mod(value, value, sec);
-
-				// evaluate as a arithmetic power
-				else if(oper.get_text() == lexer::OPER_DATA[lexer::POW]) {
-					uint64_t exp;
-					token::convert_to_integer(value, accum.get_text());
-					exp = token::convert_to<uint64_t>(second.get_text());
-					mpz_pow_ui(value, value, exp);
+			if(accum.is_integer()
+					&& second.is_integer()) {
+				mpz_t &value = accum.get_integer(), &sec = second.get_integer();
+				switch(oper) {
+
+					// evaluate as a arithmetic plus
+					case lexer::PLUS: mpz_add(value, value, sec);
+						break;
+
+					// evaluate as a arithmetic minus
+					case lexer::MINUS: mpz_sub(value, value, sec);
+						break;
+
+					// evaluate as a arithmetic multiply
+					case lexer::MULTI:
+						reserve(get_log2(value) + get_log2(sec));
+						par_int::mul(value, value, sec);
+						break;
+
+					// evaluate as a arithmetic divide
+					case lexer::DIV: mpz_div(value, value, sec);
+						break;
+
+					// evaluate as a arithmetic modulo
+					case lexer::MOD: mpz_mod(value, value, sec);
+						break;
+
+					// evaluate as a arithmetic power
+					case lexer::POW:
+						count = get_count(second);
+						reserve(get_log2(value) * count);
+						mpz_pow_ui(value, value, count);
+						break;
+					default:
+						throw exc_code::INVALID_ARITHMETIC_OPERATOR;
+						break;
 				}
-				token::convert_to_string(value, output);
-				mpz_clear(value);
-				mpz_clear(sec);
+				accum.demote();
 
 			// evauate floating-point values
-			} else if(type == token::FLOAT) {
-				mpf_t value, sec;
-				token::convert_to_float(value, accum.get_text());
-				token::convert_to_float(sec, second.get_text());
-
-				// evaluate as a arithmetic plus
-				if(oper.get_text() == lexer::OPER_DATA[lexer::PLUS])
-					mpf_add(value, value, sec);
-
-				// evaluate as a arithmetic minus
-				else if(oper.get_text() == lexer::OPER_DATA[lexer::MINUS])
-					mpf_sub(value, value, sec);
-
-				// evaluate as a arithmetic multiply
-				else if(oper.get_text() == lexer::OPER_DATA[lexer::MULTI])
-					mpf_mul(value, value, sec);
-
-				// evaluate as a arithmetic divide
-				else if(oper.get_text() == lexer::OPER_DATA[lexer::DIV])
-					mpf_div(value, value, sec);
-
-				// evaluate as a arithmetic modulo
-				else if(oper.get_text() == lexer::OPER_DATA[lexer::MOD])
-					throw exc_code::EXPECTING_INTEGER_OPERAND;
-
-				// evaluate as a arithmetic power
-				else if(oper.get_text() == lexer::OPER_DATA[lexer::POW]) {
-					uint64_t exp;
-					token::convert_to_float(value, accum.get_text());
-					exp = token::convert_to<uint64_t>(second.get_text());
-					mpf_pow_ui(value, value, exp);
+			} else {
+				accum.to_float();
+				second.to_float();
+
+				// evaluate hardware floats directly, unless the operation overflows
+				if(accum.is_hardware()
+						&& second.is_hardware()
+						&& eval_hardware(oper, accum, second))
+					break;
+				mpfr_t &value = accum.get_float(), &sec = second.get_float();
+				switch(oper) {
+
+					// evaluate as a arithmetic plus
+					case lexer::PLUS: mpfr_add(value, value, sec, GMP_RNDN);
+						break;
+
+					// evaluate as a arithmetic minus
+					case lexer::MINUS: mpfr_sub(value, value, sec, GMP_RNDN);
+						break;
+
+					// evaluate as a arithmetic multiply
+					case lexer::MULTI: mpfr_mul(value, value, sec, GMP_RNDN);
+						break;
+
+					// evaluate as a arithmetic divide
+					case lexer::DIV: mpfr_div(value, value, sec, GMP_RNDN);
+						break;
+
+					// evaluate as a arithmetic modulo
+					case lexer::MOD: throw exc_code::EXPECTING_INTEGER_OPERAND;
+						break;
+
+					// evaluate as a arithmetic power
+					case lexer::POW: mpfr_pow_ui(value, value, get_count(second), GMP_RNDN);
+						break;
+					default:
+						throw exc_code::INVALID_ARITHMETIC_OPERATOR;
+						break;
 				}
-				token::convert_to_string(value, output);
-				mpf_clear(value);
-				mpf_clear(sec);
-			} else
-				throw exc_code::INVALID_ARITHMETIC_OPERATOR;
+			}
 			break;
 		default:
 			throw exc_code::INVALID_OPERATOR;
 			break;
 	}
-	accum.set_type(type);
-	accum.set_text(output);
+}
+
+/*
+ * Evaluate a libm function over a hardware float, returning false if multi-precision is required
+ */
+bool calc::eval_hardware(num_value &value, double (*funct)(double)) {
+	double result;
+
+	// check that the value is held in hardware
+	if(!value.is_hardware())
+		return false;
+
+	// fall back to multi-precision if the result overflows (or is undefined)
+	result = funct(value.get_hardware());
+	if(!std::isfinite(result)
+			&& std::isfinite(value.get_hardware()))
+		return false;
+	value.set_hardware(result);
+	return true;
+}
+
+/*
+ * Evaluate an operator over hardware floats, returning false if multi-precision is required
+ */
+bool calc::eval_hardware(unsigned int oper, num_value &accum, num_value &second) {
+	double value = accum.get_hardware(), sec = second.get_hardware(), result;
+
+	// evaluate as an arithmetic operator
+	switch(oper) {
+		case lexer::PLUS: result = value + sec;
+			break;
+		case lexer::MINUS: result = value - sec;
+			break;
+		case lexer::MULTI: result = value * sec;
+			break;
+		case lexer::DIV: result = value / sec;
+			break;
+		case lexer::POW: result = std::pow(value, (double) get_count(second));
+			break;
+		default:
+			return false;
+	}
+
+	// fall back to multi-precision if the result overflows (or is undefined)
+	if(!std::isfinite(result)
+			&& std::isfinite(value)
+			&& std::isfinite(sec))
+		return false;
+	accum.set_hardware(result);
+	return true;
+}
+
+/*
+ * Evaluate a product of values (at most FUSE_TERMS), leaving the result in the first value (integers are
+ * multiplied smallest first)
+ */
+void calc::eval_product(num_value *terms, size_t count) {
+	bool exact = true, small = true;
+	size_t live = count, first, second;
+	size_t bits[FUSE_TERMS], order[FUSE_TERMS];
+
+	// check that each term is a valid operand
+	for(size_t i = 0; i < count; i++) {
+		if(!terms[i].is_integer()
+				&& !terms[i].is_float())
+			throw exc_code::INVALID_OPERAND;
+		exact &= terms[i].is_integer();
+		small &= terms[i].is_small();
+	}
+
+	// multiply in turn (last terms first, as the chain nests) unless every term is an integer, some of which
+	// are multi-precision
+	if(!exact
+			|| small) {
+		for(size_t i = count - 1; i > 0; i--) {
+			eval_operator(token::OPER, lexer::MULTI, terms[i - 1], terms[i]);
+			terms[i].clear();
+		}
+		return;
+	}
+
+	// multiply the two smallest terms until one remains, keeping the operands of each multiply balanced
+	for(size_t i = 0; i < count; i++) {
+		bits[i] = terms[i].get_bits();
+		order[i] = i;
+	}
+	while(live > 1) {
+		first = 0;
+		second = 1;
+		if(bits[order[second]] < bits[order[first]])
+			std::swap(first, second);
+		for(size_t i = 2; i < live; i++)
+			if(bits[order[i]] < bits[order[first]]) {
+				second = first;
+				first = i;
+			} else if(bits[order[i]] < bits[order[second]])
+				second = i;
+		eval_operator(token::OPER, lexer::MULTI, terms[order[first]], terms[order[second]]);
+		terms[order[second]].clear();
+		bits[order[first]] = terms[order[first]].get_bits();
+		order[second] = order[--live];
+	}
+	if(order[0])
+		terms[0].swap(terms[order[0]]);
+}
+
+/*
+ * Evaluate a multiply, divide or modulo by a power of 2 as a shift or mask, returning false if the value is
+ * not an integer
+ */
+bool calc::eval_shift(unsigned int oper, num_value &accum, num_value &power) {
+	int64_t result;
+	unsigned long count;
+
+	// only integers are shifted
+	if(!accum.is_integer())
+		return false;
+	count = __builtin_ctzll(power.get_small());
+
+	// shift machine-word integers directly, unless the shift overflows
+	if(accum.is_small())
+		switch(oper) {
+
+			// multiply (overflows unless the shifted value fits)
+			case lexer::MULTI:
+				if(__builtin_mul_overflow(accum.get_small(), power.get_small(), &result))
+					break;
+				accum.set_small(result);
+				return true;
+
+			// divide (an arithmetic shift rounds towards negative infinity, as mpz_div)
+			case lexer::DIV: accum.set_small(accum.get_small() >> count);
+				return true;
+
+			// modulo (a mask is non-negative, as mpz_mod)
+			case lexer::MOD: accum.set_small(accum.get_small() & (power.get_small() - 1));
+				return true;
+			default:
+				return false;
+		}
+
+	// shift multi-precision integers
+	mpz_t &value = accum.get_integer();
+	switch(oper) {
+		case lexer::MULTI:
+			reserve(get_log2(value) + count);
+			mpz_mul_2exp(value, value, count);
+			break;
+		case lexer::DIV: mpz_fdiv_q_2exp(value, value, count);
+			break;
+		case lexer::MOD: mpz_fdiv_r_2exp(value, value, count);
+			break;
+		default:
+			return false;
+	}
+	accum.demote();
+	return true;
+}
+
+/*
+ * Evaluate an operator over machine-word integers, returning false on overflow
+ */
+bool calc::eval_small(unsigned int type, unsigned int oper, num_value &accum, num_value &second) {
+	int64_t value = accum.get_small(), sec = second.get_small(), result;
+
+	// evaluate as a binary operator (cannot overflow)
+	if(type == token::BINARY_OPER) {
+		switch(oper) {
+			case lexer::AND: result = value & sec;
+				break;
+			case lexer::OR: result = value | sec;
+				break;
+			case lexer::XOR: result = value ^ sec;
+				break;
+			default:
+				return false;
+		}
+
+	// evaluate as a logical operator
+	} else if(type == token::LOGICAL_OPER) {
+		if(sec < 0)
+			return false;
+		switch(oper) {
+
+			// left shift (overflows unless the shifted value fits)
+			case lexer::LEFT_SHIFT:
+				if(sec > 62
+						|| __builtin_mul_overflow(value, (int64_t) 1 << sec, &result))
+					return false;
+				break;
+
+			// right shift (truncates towards zero, as mpz_tdiv_q_2exp)
+			case lexer::RIGHT_SHIFT:
+				if(sec > 63)
+					result = 0;
+				else if(value >= 0)
+					result = value >> sec;
+				else
+					result = -(int64_t) ((0 - (uint64_t) value) >> sec);
+				break;
+			default:
+				return false;
+		}
+
+	// evaluate as an arithmetic operator
+	} else if(type == token::OPER) {
+		switch(oper) {
+			case lexer::PLUS:
+				if(__builtin_add_overflow(value, sec, &result))
+					return false;
+				break;
+			case lexer::MINUS:
+				if(__builtin_sub_overflow(value, sec, &result))
+					return false;
+				break;
+			case lexer::MULTI:
+				if(__builtin_mul_overflow(value, sec, &result))
+					return false;
+				break;
+
+			// divide (rounds towards negative infinity, as mpz_div)
+			case lexer::DIV:
+				if(!sec
+						|| (value == INT64_MIN && sec == -1))
+					return false;
+				result = value / sec;
+				if((value % sec)
+						&& ((value < 0) != (sec < 0)))
+					result--;
+				break;
+
+			// modulo (non-negative, as mpz_mod)
+			case lexer::MOD:
+				if(!sec
+						|| sec == -1)
+					return false;
+				result = value % sec;
+				if(result < 0)
+					result += (sec < 0) ? -sec : sec;
+				break;
+
+			// power (by squaring)
+			case lexer::POW:
+				if(sec < 0)
+					return false;
+				result = 1;
+				while(sec) {
+					if((sec & 1)
+							&& __builtin_mul_overflow(result, value, &result))
+						return false;
+					sec >>= 1;
+					if(sec
+							&& __builtin_mul_overflow(value, value, &value))
+						return false;
+				}
+				break;
+			default:
+				return false;
+		}
+	} else
+		return false;
+	accum.set_small(result);
+	return true;
+}
+
+/*
+ * Evaluate a sum of values (at most FUSE_TERMS), leaving the result in the first value (sums holding
+ * multi-precision floats are rounded once, integers are added exactly)
+ */
+void calc::eval_sum(num_value *terms, size_t count) {
+	bool exact = true, hardware = (num_value::get_mode() == num_value::HARDWARE);
+	size_t floats = 0, integral = count, bits;
+	num_value result;
+	mpfr_t integer;
+	mpfr_ptr values[FUSE_TERMS];
+
+	// check that each term is a valid operand
+	for(size_t i = 0; i < count; i++) {
+		if(!terms[i].is_integer()
+				&& !terms[i].is_float())
+			throw exc_code::INVALID_OPERAND;
+		exact &= !terms[i].is_float();
+		hardware |= terms[i].is_hardware();
+	}
+
+	// add in turn (last terms first, as the chain nests) unless the terms include multi-precision floats
+	// (& no hardware floats)
+	if(exact
+			|| hardware) {
+		for(size_t i = count - 1; i > 0; i--) {
+			eval_operator(token::OPER, lexer::PLUS, terms[i - 1], terms[i]);
+			terms[i].clear();
+		}
+		return;
+	}
+
+	// add the integer terms exactly, into the first of them
+	for(size_t i = 0; i < count; i++)
+		if(terms[i].is_float())
+			values[floats++] = terms[i].get_float();
+		else if(integral == count)
+			integral = i;
+		else {
+			eval_operator(token::OPER, lexer::PLUS, terms[integral], terms[i]);
+			terms[i].clear();
+		}
+
+	// sum the floats & the integers' sum (held exactly) exactly, rounding once
+	if(integral != count) {
+		bits = terms[integral].get_bits();
+		reg_pool::acquire(integer, std::max<mpfr_prec_t>(bits, MPFR_PREC_MIN));
+		if(terms[integral].is_small())
+			mpfr_set_si(integer, terms[integral].get_small(), GMP_RNDN);
+		else
+			mpfr_set_z(integer, terms[integral].get_integer(), GMP_RNDN);
+		values[floats++] = integer;
+	}
+	mpfr_sum(result.set_float(), values, floats, GMP_RNDN);
+	if(integral != count)
+		reg_pool::release(integer);
+	terms[0].swap(result);
+	for(size_t i = 1; i < count; i++)
+		terms[i].clear();
 }
 
 /*
  * Evaluates a given input string and state
  */
-int calc::eval_input(std::string &input, sym_table &state) {
+int calc::eval_input(std::string &input, sym_table &state, std::ostream &stream) {
 	token tok;
 	parser par;
+	num_value value;
+	sub_table shared;
 	std::string output;
+	std::vector<byte_code> code;
+	std::vector<num_value> stack, slots;
 	syn_tree copy, *curr = NULL;
-	std::vector<syn_tree *>::iterator i;
 	unsigned int root_type;
 
 	try {
@@ -830,18 +1449,45 @@ int calc::eval_input(std::string &input, sym_table &state) {
 		par = parser(input);
 		par.parse();
 		std::vector<syn_tree *> tree = par.get_syntax_tree();
-		i = tree.begin();
 
-		// iterate through trees
-		for(; i != tree.end(); ++i) {
-			curr = *i;
+		// compile & fold each statement, keying its subexpressions (assignments redefine their identifier)
+		code.resize(tree.size());
+		for(size_t i = 0; i < tree.size(); i++) {
+			curr = tree[i];
+			curr->advance_root();
+			curr->get_type(root_type);
+			if(root_type == token::ASSIGNMENT) {
+				curr->get_child_text(output, 0);
+				curr->advance_forward(1);
+			} else if(root_type != token::EXPRESSION)
+				continue;
+			code[i].compile(*curr);
+			fold_code(code[i]);
+			reduce_code(code[i]);
+			shared.add(code[i]);
+			if(root_type == token::ASSIGNMENT)
+				shared.assign(sym_table::intern(output));
+		}
+
+		// evaluate subexpressions shared by (or within) statements once, fusing the operations that remain
+		for(size_t i = 0; i < tree.size(); i++)
+			if(code[i].size()) {
+				shared.share(code[i]);
+				fuse_code(code[i]);
+			}
+		slots.resize(shared.get_slots());
+
+		// iterate through trees, measuring the peak memory of each statement
+		for(size_t i = 0; i < tree.size(); i++) {
+			reg_pool::reset_peak();
+			curr = tree[i];
 			curr->advance_root();
 			curr->get_type(root_type);
 			output.clear();
 
 			// TODO: for debugging (remove)
 			/*std::string str;
-			syn_tree::print_tree(**i, str);
+			syn_tree::print_tree(*curr, str);
 			std::cout << str << std::endl;*/
 
 			// evaluate based off root token type
@@ -852,9 +1498,10 @@ int calc::eval_input(std::string &input, sym_table &state) {
 					curr->get_child_text(output, 0);
 
 					// evaulate assignment expression
-					curr->advance_forward(1);
-					eval_expression(*curr, state);
-					curr->get_contents(tok);
+					eval_code(code[i], state, stack, slots, value);
+					if(reg_pool::is_exceeded())
+						throw exc_code::MEM_LIMIT;
+					tok.swap_value(value);
 
 					// set value
 					state.set_value(output, tok);
@@ -864,14 +1511,14 @@ int calc::eval_input(std::string &input, sym_table &state) {
 				case token::EXPRESSION:
 
 					// evaluate expression
-					eval_expression(*curr, state);
-					curr->advance_root();
-					curr->get_text(output);
+					eval_code(code[i], state, stack, slots, value);
+					if(reg_pool::is_exceeded())
+						throw exc_code::MEM_LIMIT;
 
-					// print output
-					if(output.empty())
+					// write output (large values are written as they are converted)
+					if(!value.write(stream))
 						continue;
-					std::cout << output << std::endl;
+					stream << std::endl;
 					break;
 
 				default: throw exc_code::INVALID_EXPRESSION;
@@ -936,11 +1583,142 @@ int calc::get_commands(const std::string &input, std::vector<std::string> &comma
 	return commands.size();
 }
 
+/*
+ * Removes an output redirection (expression > file) from input, returning true if one was found
+ */
+bool calc::get_redirect(std::string &input, std::string &path) {
+	size_t pos = input.size(), begin, end;
+
+	// find the last lone '>' (distinct from a right shift)
+	while(pos--)
+		if(input.at(pos) == '>'
+				&& (!pos || input.at(pos - 1) != '>')
+				&& (pos + 1 == input.size() || input.at(pos + 1) != '>'))
+			break;
+	if(pos == std::string::npos)
+		return false;
+
+	// trim whitespace surrounding the path
+	begin = input.find_first_not_of(" \t", pos + 1);
+	end = input.find_last_not_of(" \t");
+	path.assign((begin == std::string::npos) ? "" : input.substr(begin, end - begin + 1));
+	input.erase(pos);
+	return true;
+}
+
+/*
+ * Parse a non-negative decimal integer from a string
+ */
+bool calc::parse_unsigned(const std::string &str, unsigned long &value) {
+	char *end = NULL;
+
+	// check that the string holds only a decimal count
+	if(str.empty()
+			|| !isdigit(str.at(0)))
+		return false;
+	errno = 0;
+	value = strtoul(str.c_str(), &end, 10);
+	return !*end && !errno;
+}
+
+/*
+ * Checks that a result of a given size (in bits) fits under the memory limit
+ */
+void calc::reserve(double bits) {
+
+	// refuse the operation, rather than letting libgmp exhaust memory
+	if(!reg_pool::fits(bits / CHAR_BIT))
+		throw exc_code::MEM_LIMIT;
+}
+
+/*
+ * Set the integer output radix from a string
+ */
+bool calc::set_base(const std::string &base) {
+	unsigned long value;
+
+	// parse & apply the radix
+	return calc::parse_unsigned(base, value)
+			&& num_value::set_base(value);
+}
+
+/*
+ * Set the display limit from a string (in digits)
+ */
+bool calc::set_limit(const std::string &limit) {
+	unsigned long value;
+
+	// parse & apply the limit
+	if(!calc::parse_unsigned(limit, value))
+		return false;
+	num_value::set_limit(value);
+	return true;
+}
+
+/*
+ * Set the memory limit from a string (in megabytes)
+ */
+bool calc::set_max_mem(const std::string &megabytes) {
+	unsigned long value;
+
+	// parse & apply the limit
+	if(!calc::parse_unsigned(megabytes, value)
+			|| value > (SIZE_MAX >> 20))
+		return false;
+	reg_pool::set_limit(value << 20);
+	return true;
+}
+
+/*
+ * Set the floating-point working precision from a string (in bits)
+ */
+bool calc::set_precision(const std::string &bits) {
+	unsigned long value;
+
+	// parse & apply the precision
+	if(!calc::parse_unsigned(bits, value)
+			|| !num_value::set_precision(value))
+		return false;
+
+	// constants & pooled registers held at the previous precision are stale
+	calc::clear_constants();
+	reg_pool::set_precision(value);
+	return true;
+}
+
+/*
+ * Reseed the session random number generator from a string
+ */
+bool calc::set_seed(const std::string &seed) {
+	unsigned long value;
+
+	// parse & apply the seed
+	if(!calc::parse_unsigned(seed, value))
+		return false;
+	calc::generator.set_seed(value);
+	return true;
+}
+
+/*
+ * Set the number of worker threads from a string
+ */
+bool calc::set_threads(const std::string &threads) {
+	unsigned long value;
+
+	// parse & apply the thread count
+	return calc::parse_unsigned(threads, value)
+			&& value <= UINT_MAX
+			&& par_int::set_threads(value);
+}
+
 /*
  * Main
  */
 int main(int argc, char *argv[]) {
 	srand(time(NULL));
+	reg_pool::initialize();
+	reg_pool::set_precision(num_value::get_precision());
+	calc::generator.set_seed(time(NULL));
 	std::string input;
 	std::vector<std::string> commands;
 	std::vector<std::string>::iterator cmd;
@@ -948,38 +1726,107 @@ int main(int argc, char *argv[]) {
 	long exit_code = exc_code::SUCCESS;
 	sym_table state;
 
+	bool run_input = true;
+
 	// if arguments are given read them in as input
-	if(argc > 1) {
-		bool run_input = true;
-		for(int i = 1; i < argc; i++) {
-			input = argv[i];
-
-			// parse input as a command-line command
-			if(calc::C_CMD_SET.find(argv[i]) != calc::C_CMD_SET.end()) {
-				run_input = false;
-				if(input == calc::C_CMD_DATA[calc::C_HELP]) {
-					std::cout << calc::VERSION << " -- " << calc::COPYRIGHT << std::endl << calc::WARRANTY << std::endl << std::endl;
-					std::cout << calc::C_CMD_DATA[calc::C_HELP] << "\t\tDisplay help information" << std::endl << std::endl;
-					std::cout << calc::C_CMD_DATA[calc::C_VERSION] << "\tDisplay version information" << std::endl << std::endl;
-					std::cout << "If no input is given, set to interactive mode, otherwise" << std::endl;
-					std::cout << "expressions will be evaluated in order that they appear." << std::endl << std::endl;
-				} else if(input == calc::C_CMD_DATA[calc::C_VERSION])
-					std::cout << calc::VERSION << " -- " << calc::COPYRIGHT << std::endl << calc::WARRANTY << std::endl << std::endl;
-				else
-					std::cerr << "Unknown command: " << input << std::endl;
-				break;
-			} else
-				commands.push_back(input);
-		}
+	for(int i = 1; i < argc; i++) {
+		input = argv[i];
+
+		// parse input as a command-line command
+		if(calc::C_CMD_SET.find(argv[i]) != calc::C_CMD_SET.end()) {
+
+			// set integer output radix from the following argument (options do not stop input)
+			if(input == calc::C_CMD_DATA[calc::C_BASE]) {
+				if(i + 1 < argc
+						&& calc::set_base(argv[++i]))
+					continue;
+				std::cerr << "Invalid base" << std::endl;
+				return exc_code::INVALID_OPERAND;
+			}
 
-		// run command-line input, if appropriate
-		if(run_input
-				&& commands.size())
-			for(cmd = commands.begin(); cmd != commands.end(); ++cmd)
-				exit_code = calc::check_input(*cmd, state);
+			// set hardware floating-point mode
+			if(input == calc::C_CMD_DATA[calc::C_FAST]) {
+				num_value::set_mode(num_value::HARDWARE);
+				continue;
+			}
+
+			// set display limit from the following argument
+			if(input == calc::C_CMD_DATA[calc::C_LIMIT]) {
+				if(i + 1 < argc
+						&& calc::set_limit(argv[++i]))
+					continue;
+				std::cerr << "Invalid limit" << std::endl;
+				return exc_code::INVALID_OPERAND;
+			}
+
+			// set memory limit from the following argument
+			if(input == calc::C_CMD_DATA[calc::C_MAX_MEM]) {
+				if(i + 1 < argc
+						&& calc::set_max_mem(argv[++i]))
+					continue;
+				std::cerr << "Invalid memory limit" << std::endl;
+				return exc_code::INVALID_OPERAND;
+			}
+
+			// set floating-point working precision from the following argument
+			if(input == calc::C_CMD_DATA[calc::C_PRECISION]) {
+				if(i + 1 < argc
+						&& calc::set_precision(argv[++i]))
+					continue;
+				std::cerr << "Invalid precision" << std::endl;
+				return exc_code::INVALID_OPERAND;
+			}
+
+			// reseed random number generator from the following argument
+			if(input == calc::C_CMD_DATA[calc::C_SEED]) {
+				if(i + 1 < argc
+						&& calc::set_seed(argv[++i]))
+					continue;
+				std::cerr << "Invalid seed" << std::endl;
+				return exc_code::INVALID_OPERAND;
+			}
+
+			// set number of worker threads from the following argument
+			if(input == calc::C_CMD_DATA[calc::C_THREADS]) {
+				if(i + 1 < argc
+						&& calc::set_threads(argv[++i]))
+					continue;
+				std::cerr << "Invalid threads" << std::endl;
+				return exc_code::INVALID_OPERAND;
+			}
+			run_input = false;
+			if(input == calc::C_CMD_DATA[calc::C_HELP]) {
+				std::cout << calc::VERSION << " -- " << calc::COPYRIGHT << std::endl << calc::WARRANTY << std::endl << std::endl;
+				std::cout << calc::C_CMD_DATA[calc::C_BASE] << " [n]\tPrint integers in base 2, 8, 10 or 16 (default: 10)" << std::endl << std::endl;
+				std::cout << calc::C_CMD_DATA[calc::C_FAST] << "\t\tEvaluate floating-point in hardware (double-precision)" << std::endl << std::endl;
+				std::cout << calc::C_CMD_DATA[calc::C_HELP] << "\t\tDisplay help information" << std::endl << std::endl;
+				std::cout << calc::C_CMD_DATA[calc::C_LIMIT] << " [n]\tSummarize results longer than n digits (default: 0, unlimited)" << std::endl << std::endl;
+				std::cout << calc::C_CMD_DATA[calc::C_MAX_MEM] << " [mb]\tLimit memory held by values (default: 0, unlimited)" << std::endl << std::endl;
+				std::cout << calc::C_CMD_DATA[calc::C_PRECISION] << " [bits]\tSet floating-point working precision (default: "
+						<< num_value::DEFAULT_PRECISION << ")" << std::endl << std::endl;
+				std::cout << calc::C_CMD_DATA[calc::C_SEED] << " [n]\tSeed the random number generator (default: time)" << std::endl << std::endl;
+				std::cout << calc::C_CMD_DATA[calc::C_THREADS] << " [n]\tWorker threads for large integers (default: cores)" << std::endl << std::endl;
+				std::cout << calc::C_CMD_DATA[calc::C_VERSION] << "\tDisplay version information" << std::endl << std::endl;
+				std::cout << "If no input is given, set to interactive mode, otherwise" << std::endl;
+				std::cout << "expressions will be evaluated in order that they appear." << std::endl << std::endl;
+			} else if(input == calc::C_CMD_DATA[calc::C_VERSION])
+				std::cout << calc::VERSION << " -- " << calc::COPYRIGHT << std::endl << calc::WARRANTY << std::endl << std::endl;
+			else
+				std::cerr << "Unknown command: " << input << std::endl;
+			break;
+		} else
+			commands.push_back(input);
+	}
+
+	// run command-line input, if appropriate
+	if(!run_input)
+		;
+	else if(commands.size())
+		for(cmd = commands.begin(); cmd != commands.end(); ++cmd)
+			exit_code = calc::check_input(*cmd, state);
 
 	// else, enter interactive-mode
-	} else {
+	else {
 
 		// trap ctrl^c keyboard interrupt
 		std::signal(SIGINT, calc::keyboard_interrupt0);
@@ -1014,5 +1861,7 @@ int main(int argc, char *argv[]) {
 
 	// release resources
 	state.cleanup();
+	calc::clear_constants();
+	reg_pool::cleanup();
 	return exit_code;
 }
@@ -21,12 +21,20 @@
 #ifndef CALC_HPP_
 #define CALC_HPP_
 
+#include <map>
+#include <set>
 #include <string>
 #include <gmp.h>
 #include <mpfr.h>
 #include <vector>
+#include "byte_code.hpp"
 #include "exc_code.hpp"
+#include "num_value.hpp"
+#include "par_int.hpp"
 #include "parser.hpp"
+#include "rand_gen.hpp"
+#include "reg_pool.hpp"
+#include "sub_table.hpp"
 #include "sym_table.hpp"
 #include "syn_tree.hpp"
 #include "token.hpp"
@@ -43,7 +51,7 @@ public:
 	 * Help information
 	 */
 	static const std::string HELP_INFO_DATA[];
-	static const unsigned int HELP_INFO_DATA_SIZE = 28;
+	static const unsigned int HELP_INFO_DATA_SIZE = 37;
 
 	/*
 	 * Help information notification
@@ -68,57 +76,194 @@ public:
 	/*
 	 * Built-in commands
 	 */
-	enum CMD { ABOUT, EXIT, HELP, RESET, STATE };
+	enum CMD { ABOUT, BASE, EXIT, FAST, HELP, LIMIT, PRECISION, RESET, SEED, STATE, STATS, THREADS };
 	static const std::string CMD_DATA[];
 	static const std::set<std::string> CMD_SET;
 
 	/*
 	 * Command-line commands
 	 */
-	enum C_CMD { C_HELP, C_VERSION };
+	enum C_CMD { C_BASE, C_FAST, C_HELP, C_LIMIT, C_MAX_MEM, C_PRECISION, C_SEED, C_THREADS, C_VERSION };
 	static const std::string C_CMD_DATA[];
 	static const std::set<std::string> C_CMD_SET;
 
+	/*
+	 * Maximum number of terms fused into a single sum or product
+	 */
+	static const unsigned int FUSE_TERMS = 32;
+
+	/*
+	 * Constants cached at the working precision
+	 */
+	static std::map<std::string, num_value> constant_cache;
+
+	/*
+	 * Session random number generator
+	 */
+	static rand_gen generator;
+
 	/*
 	 * Checks input for commands prior to evaluation
 	 */
 	static int check_input(std::string &input, sym_table &state);
 
 	/*
-	 * Convert mpfr_t to string
+	 * Release cached constants
+	 */
+	static void clear_constants(void);
+
+	/*
+	 * Evaluate a program over a stack of values (reused between programs) & slots of shared values, leaving its
+	 * value in result
 	 */
-	static bool convert_to_string(mpfr_t &value, const unsigned int precision, std::string &output);
+	static void eval_code(byte_code &code, sym_table &state, std::vector<num_value> &stack, std::vector<num_value> &slots,
+			num_value &result);
 
 	/*
 	 * Evaluate a constant
 	 */
-	static void eval_constant(syn_tree &tree);
+	static void eval_constant(unsigned int code, num_value &result);
+
+	/*
+	 * Evaluate a function over a value
+	 */
+	static void eval_function(unsigned int code, num_value &child);
 
 	/*
-	 * Evaluate an expression
+	 * Evaluate a libm function over a hardware float, returning false if multi-precision is required
 	 */
-	static void eval_expression(syn_tree &tree, sym_table &state);
+	static bool eval_hardware(num_value &value, double (*funct)(double));
 
 	/*
-	 * Evaluate a function
+	 * Evaluate an operator over hardware floats, returning false if multi-precision is required
 	 */
-	static void eval_function(syn_tree &tree, sym_table &state);
+	static bool eval_hardware(unsigned int oper, num_value &accum, num_value &second);
 
 	/*
-	 * Evaluate an operator
+	 * Evaluate an operator over an accumulator & second operand
 	 */
-	static void eval_operator(syn_tree &tree, token &accum, sym_table &state);
+	static void eval_operator(unsigned int type, unsigned int oper, num_value &accum, num_value &second);
+
+	/*
+	 * Evaluate a product of values (at most FUSE_TERMS), leaving the result in the first value (integers are
+	 * multiplied smallest first)
+	 */
+	static void eval_product(num_value *terms, size_t count);
+
+	/*
+	 * Evaluate a multiply, divide or modulo by a power of 2 as a shift or mask, returning false if the value is
+	 * not an integer
+	 */
+	static bool eval_shift(unsigned int oper, num_value &accum, num_value &power);
+
+	/*
+	 * Evaluate an operator over machine-word integers, returning false on overflow
+	 */
+	static bool eval_small(unsigned int type, unsigned int oper, num_value &accum, num_value &second);
+
+	/*
+	 * Evaluate a sum of values (at most FUSE_TERMS), leaving the result in the first value (sums holding
+	 * multi-precision floats are rounded once, integers are added exactly)
+	 */
+	static void eval_sum(num_value *terms, size_t count);
 
 	/*
 	 * Evaluates a given input string and state
 	 */
-	static int eval_input(std::string &input, sym_table &state);
+	static int eval_input(std::string &input, sym_table &state, std::ostream &stream);
+
+	/*
+	 * Folds the constant operations of a program into literals (random numbers are never folded)
+	 */
+	static void fold_code(byte_code &code);
+
+	/*
+	 * Fuses the chains of additions & multiplications in a program into sums & products of several terms
+	 */
+	static void fuse_code(byte_code &code);
+
+	/*
+	 * Rewrites the operations of a program into cheaper equivalents (squares, shifts & masks by powers of 2,
+	 * casts through a float)
+	 */
+	static void reduce_code(byte_code &code);
+
+	/*
+	 * Returns a non-negative integer operand as a count (shift, exponent, etc.)
+	 */
+	static unsigned long get_count(num_value &value);
+
+	/*
+	 * Returns the base-2 logarithm of an integer's magnitude (0 for zero)
+	 */
+	static double get_log2(const mpz_t value);
+
+	/*
+	 * Returns the number of terms an instruction adds or multiplies (1 unless it is an addition or sum, or a
+	 * multiplication or product, as given by the operator)
+	 */
+	static unsigned int get_terms(byte_code::instruction &instr, unsigned int oper);
+
+	/*
+	 * Returns true if an instruction pushes a literal power of 2 held in a machine word
+	 */
+	static bool is_power2(byte_code &code, byte_code::instruction &instr);
 
 	/*
 	 * Returns a series of individual commands parsed from input
 	 */
 	static int get_commands(const std::string &input, std::vector<std::string> &commands);
 
+	/*
+	 * Removes an output redirection (expression > file) from input, returning true if one was found
+	 */
+	static bool get_redirect(std::string &input, std::string &path);
+
+	/*
+	 * Parse a non-negative decimal integer from a string
+	 */
+	static bool parse_unsigned(const std::string &str, unsigned long &value);
+
+	/*
+	 * Checks that a result of a given size (in bits) fits under the memory limit
+	 */
+	static void reserve(double bits);
+
+	/*
+	 * Set the integer output radix from a string
+	 */
+	static bool set_base(const std::string &base);
+
+	/*
+	 * Set the display limit from a string (in digits)
+	 */
+	static bool set_limit(const std::string &limit);
+
+	/*
+	 * Set the memory limit from a string (in megabytes)
+	 */
+	static bool set_max_mem(const std::string &megabytes);
+
+	/*
+	 * Set the floating-point working precision from a string (in bits)
+	 */
+	static bool set_precision(const std::string &bits);
+
+	/*
+	 * Reseed the session random number generator from a string
+	 */
+	static bool set_seed(const std::string &seed);
+
+	/*
+	 * Set the number of worker threads from a string
+	 */
+	static bool set_threads(const std::string &threads);
+
+	/*
+	 * Square a hardware float
+	 */
+	static double sqr_hardware(double value) { return value * value; }
+
 	/*
 	 * Handle Ctrl^C keyboard interrupts
 	 */
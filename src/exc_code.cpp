@@ -23,7 +23,7 @@
 /*
  * Exception message
  */
-const std::string exc_code::MESSAGE[22] = {
+const std::string exc_code::MESSAGE[23] = {
 
 	/*
 	 * General exceptions
@@ -58,4 +58,5 @@ const std::string exc_code::MESSAGE[22] = {
 	"Undefined identifier",
 	"Expecting positive integer operands",
 	"Invalid unary operator",
+	"Memory limit exceeded",
 };
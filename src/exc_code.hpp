@@ -59,6 +59,7 @@ public:
 	static const int UNDEFINED_IDENTIFIER = 19;
 	static const int EXPECTING_POSITIVE_INTEGER_OPERAND = 20;
 	static const int INVALID_UNARY_OPERATOR = 21;
+	static const int MEM_LIMIT = 22;
 
 	/*
 	 * Exception message
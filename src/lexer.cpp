@@ -18,6 +18,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <cstddef>
 #include "lexer.hpp"
 
 /*
@@ -29,45 +30,79 @@ const std::string lexer::ASSIGN("make");
  * Binary operator keywords
  */
 const std::string lexer::BINARY_OPER_DATA[3] = { "&", "|", "$" };
-const std::set<std::string> lexer::BINARY_OPER(lexer::BINARY_OPER_DATA, lexer::BINARY_OPER_DATA + 3);
 
 /*
  * Constant keywords
  */
 const std::string lexer::CONSTANT_OPER_DATA[3] = { "e", "pi", "rand" };
-const std::set<std::string> lexer::CONSTANT(lexer::CONSTANT_OPER_DATA, lexer::CONSTANT_OPER_DATA + 3);
 
 /*
  * Function keywords
  */
 
-const std::string lexer::FUNCTION_OPER_DATA[22] = { "abs", "acos", "asin", "atan", "ceiling", "cos", "cosh", "fact",
-		"fib", "float", "floor", "int", "ln", "log2", "log10", "round", "sin", "sinh", "sqr", "sqrt", "tan", "tanh" };
-const std::set<std::string> lexer::FUNCTION(lexer::FUNCTION_OPER_DATA, lexer::FUNCTION_OPER_DATA + 22);
+const std::string lexer::FUNCTION_OPER_DATA[23] = { "abs", "acos", "asin", "atan", "ceiling", "cos", "cosh", "digits",
+		"fact", "fib", "float", "floor", "int", "ln", "log2", "log10", "round", "sin", "sinh", "sqr", "sqrt", "tan", "tanh" };
+
+/*
+ * Keyword table (constants, functions & the assignment keyword), indexed by a perfect hash of the
+ * keyword text (see hash_keyword), empty slots hold NULL
+ */
+const lexer::keyword lexer::KEYWORD_DATA[lexer::KEYWORD_DATA_SIZE] = {
+	{ NULL, token::STRING, 0 }, { NULL, token::STRING, 0 },
+	{ "asin", token::FUNCTION, ASIN }, { "atan", token::FUNCTION, ATAN },
+	{ NULL, token::STRING, 0 }, { NULL, token::STRING, 0 },
+	{ NULL, token::STRING, 0 }, { NULL, token::STRING, 0 },
+	{ NULL, token::STRING, 0 }, { "abs", token::FUNCTION, ABS },
+	{ NULL, token::STRING, 0 }, { NULL, token::STRING, 0 },
+	{ NULL, token::STRING, 0 }, { NULL, token::STRING, 0 },
+	{ "pi", token::CONSTANT, PI }, { NULL, token::STRING, 0 },
+	{ NULL, token::STRING, 0 }, { NULL, token::STRING, 0 },
+	{ NULL, token::STRING, 0 }, { NULL, token::STRING, 0 },
+	{ "round", token::FUNCTION, ROUND }, { "acos", token::FUNCTION, ACOS },
+	{ "cosh", token::FUNCTION, COSH }, { NULL, token::STRING, 0 },
+	{ "cos", token::FUNCTION, COS }, { "tanh", token::FUNCTION, TANH },
+	{ NULL, token::STRING, 0 }, { NULL, token::STRING, 0 },
+	{ NULL, token::STRING, 0 }, { NULL, token::STRING, 0 },
+	{ "fib", token::FUNCTION, FIB }, { "fact", token::FUNCTION, FACT },
+	{ "sinh", token::FUNCTION, SINH }, { NULL, token::STRING, 0 },
+	{ "log10", token::FUNCTION, LOG10 }, { "sqr", token::FUNCTION, SQR },
+	{ "int", token::FUNCTION, INT }, { "log2", token::FUNCTION, LOG2 },
+	{ "ceiling", token::FUNCTION, CEILING }, { "floor", token::FUNCTION, FLOOR },
+	{ NULL, token::STRING, 0 }, { NULL, token::STRING, 0 },
+	{ NULL, token::STRING, 0 }, { NULL, token::STRING, 0 },
+	{ NULL, token::STRING, 0 }, { NULL, token::STRING, 0 },
+	{ NULL, token::STRING, 0 }, { NULL, token::STRING, 0 },
+	{ NULL, token::STRING, 0 }, { NULL, token::STRING, 0 },
+	{ "ln", token::FUNCTION, LN }, { "e", token::CONSTANT, E },
+	{ "digits", token::FUNCTION, DIGITS }, { "float", token::FUNCTION, FLOAT },
+	{ NULL, token::STRING, 0 }, { NULL, token::STRING, 0 },
+	{ "tan", token::FUNCTION, TAN }, { NULL, token::STRING, 0 },
+	{ NULL, token::STRING, 0 }, { "rand", token::CONSTANT, RAND },
+	{ "sqrt", token::FUNCTION, SQRT }, { "make", token::ASSIGNMENT, 0 },
+	{ NULL, token::STRING, 0 }, { "sin", token::FUNCTION, SIN }
+};
 
 /*
  * Logical operator keywords
  */
 const std::string lexer::LOGICAL_OPER_DATA[2] = { "<<", ">>" };
-const std::set<std::string> lexer::LOGICAL_OPER(lexer::LOGICAL_OPER_DATA, lexer::LOGICAL_OPER_DATA + 2);
 
 /*
  * Operator keywords
  */
 const std::string lexer::OPER_DATA[6] = { "+", "-", "*", "/", "%", "^" };
-const std::set<std::string> lexer::OPER(lexer::OPER_DATA, lexer::OPER_DATA + 6);
 
 /*
  * Unary operator keywords
  */
 const std::string lexer::UNARY_OPER_DATA[1] = { "~" };
-const std::set<std::string> lexer::UNARY_OPER(lexer::UNARY_OPER_DATA, lexer::UNARY_OPER_DATA + 1);
 
 /*
  * Lexer constructor
  */
 lexer::lexer(void) {
 	type = token::UNDEFINED;
+	code = 0;
 }
 
 /*
@@ -75,21 +110,31 @@ lexer::lexer(void) {
  */
 lexer::lexer(const lexer &other) {
 
-	// set attributes
+	// set attributes (the buffer shares the input)
 	text.clear();
 	type = token::BEGIN;
-	input.assign(other.input);
-	buff = pb_buffer(input);
+	code = 0;
+	buff = other.buff;
 }
 
 /*
- * Lexer constructor
+ * Lexer constructor (the input is referenced, not copied, and must outlive the lexer)
  */
-lexer::lexer(const std::string &input) {
+lexer::lexer(const std::string &input) : buff(input) {
 
 	// set attributes
 	type = token::BEGIN;
-	this->input.assign(input);
+	code = 0;
+}
+
+/*
+ * Lexer constructor (the input is referenced, not copied, and must outlive the lexer)
+ */
+lexer::lexer(const char *input, size_t length) : buff(input, length) {
+
+	// set attributes
+	type = token::BEGIN;
+	code = 0;
 }
 
 /*
@@ -97,7 +142,6 @@ lexer::lexer(const std::string &input) {
  */
 lexer::~lexer(void) {
 	text.clear();
-	input.clear();
 }
 
 /*
@@ -109,11 +153,11 @@ lexer &lexer::operator=(const lexer &other) {
 	if(this == &other)
 		return *this;
 
-	// set attributes
+	// set attributes (the buffer shares the input)
 	text.clear();
 	type = token::BEGIN;
-	input.assign(other.input);
-	buff = pb_buffer(input);
+	code = 0;
+	buff = other.buff;
 	return *this;
 }
 
@@ -128,9 +172,9 @@ bool lexer::operator==(const lexer &other) {
 
 	// check if all attributes match
 	return type == other.type
+			&& code == other.code
 			&& text == other.text
-			&& buff == other.buff
-			&& input == other.input;
+			&& buff == other.buff;
 }
 
 /*
@@ -139,8 +183,20 @@ bool lexer::operator==(const lexer &other) {
 bool lexer::get_token(token &tok) {
 
 	// set appropriate values
-	tok.set_text(text);
 	tok.set_type(type);
+	tok.set_code(code);
+
+	// convert numeric literals once, when they are read (their text is not kept)
+	if(type == token::INTEGER) {
+		tok.get_text().clear();
+		tok.get_value().parse(text, num_value::INTEGER);
+	} else if(type == token::FLOAT) {
+		tok.get_text().clear();
+		tok.get_value().parse(text, num_value::FLOAT);
+	} else {
+		tok.set_text(text);
+		tok.get_value().clear();
+	}
 	return true;
 }
 
@@ -150,7 +206,6 @@ bool lexer::get_token(token &tok) {
 void lexer::initialize(void) {
 
 	// initialize
-	buff = pb_buffer(input);
 	buff.initialize();
 	text.clear();
 	next();
@@ -164,6 +219,7 @@ bool lexer::next(void) {
 	// remove whitespace from stream
 	remove_whitespace();
 	text.clear();
+	code = 0;
 
 	// Parse next character in stream to determine the tokens likely type
 	if(!buff.has_next())
@@ -177,21 +233,71 @@ bool lexer::next(void) {
 	return true;
 }
 
+/*
+ * Returns the perfect hash of a keyword's text, an index into the keyword table (a weighted sum of the
+ * first, second & last characters & length, collision-free over the keywords)
+ */
+unsigned int lexer::hash_keyword(const std::string &text) {
+
+	// text[1] is null for single character text
+	return (text[0] + text[1] + (text[text.size() - 1] * 7) + (text.size() * 11)) & (KEYWORD_DATA_SIZE - 1);
+}
+
+/*
+ * Returns true if a character is a digit in the given radix
+ */
+bool lexer::is_radix_digit(char ch, unsigned int base) {
+
+	// check the character against the digits of the radix
+	switch(base) {
+		case 2: return ch == '0' || ch == '1';
+		case 8: return ch >= '0' && ch <= '7';
+		case 16: return isxdigit(ch);
+		default: return isdigit(ch);
+	}
+}
+
 /*
  * Reads a number from the buffer
  */
 void lexer::number(void) {
+	unsigned int base = 10;
 	char ch = buff.get_current();
 
 	// set type
 	type = token::INTEGER;
 
-	// aggregate token value
-	while(isdigit(ch)) {
+	// aggregate token value (digits are read in bulk)
+	if(!buff.read_digits(text))
+		return;
+	ch = buff.get_current();
+
+	// if a radix prefix is found, token is an integer in base 2, 8 or 16
+	if(text == "0") {
+		switch(ch) {
+			case BIN: base = 2;
+				break;
+			case HEX: base = 16;
+				break;
+			case OCT: base = 8;
+				break;
+			default:
+				break;
+		}
+	}
+	if(base != 10) {
 		text += ch;
 		buff >> ch;
-		if(!buff.has_next())
-			return;
+		while(buff.has_next()
+				&& is_radix_digit(ch, base)) {
+			text += ch;
+			buff >> ch;
+		}
+
+		// a prefix without digits is not a number
+		if(text.size() == 2)
+			type = token::UNDEFINED;
+		return;
 	}
 
 	// if a decimal point is found, token is of type float
@@ -199,12 +305,7 @@ void lexer::number(void) {
 		type = token::FLOAT;
 		text += ch;
 		buff >> ch;
-		while(isdigit(ch)) {
-			text += ch;
-			buff >> ch;
-			if(!buff.has_next())
-				return;
-		}
+		buff.read_digits(text);
 	}
 }
 
@@ -221,26 +322,18 @@ void lexer::phrase(void) {
 	while(isalnum(ch)) {
 		text += ch;
 		buff >> ch;
-		if(!buff.has_next()) {
-
-			// set appropriate type
-			if(is_constant())
-				type = token::CONSTANT;
-			else if(is_function())
-				type = token::FUNCTION;
-			else if(text == ASSIGN)
-				type = token::ASSIGNMENT;
-			return;
-		}
+		if(!buff.has_next())
+			break;
 	}
 
-	// set appropriate type
-	if(is_constant())
-		type = token::CONSTANT;
-	else if(is_function())
-		type = token::FUNCTION;
-	else if(text == ASSIGN)
-		type = token::ASSIGNMENT;
+	// set appropriate type from the keyword table (a single probe), other strings are identifiers (interned
+	// once compiled)
+	const keyword &entry = KEYWORD_DATA[hash_keyword(text)];
+	if(entry.text
+			&& text == entry.text) {
+		type = entry.type;
+		code = entry.code;
+	}
 }
 
 /*
@@ -281,35 +374,48 @@ void lexer::symbol(void) {
 
 	// aggregate token value
 	text += ch;
-	if(is_operator())
-		type = token::OPER;
-	else
-		if(is_binary_operator())
-			type = token::BINARY_OPER;
-		else if(is_unary_operator())
-			type = token::UNARY_OPER;
-		else
-
-			// determine the tokens type based off complete token value
-			switch(ch) {
-				case CLS_PAREN: type = token::CLOSE_PAREN;
-					break;
-				case OPN_PAREN: type = token::OPEN_PAREN;
-					break;
-				default: type = token::UNDEFINED;
-					buff.next();
-					if(!buff.has_next())
-						return;
-					text += buff.get_current();
-					if(is_logical_operator())
-						type = token::LOGICAL_OPER;
-					else {
-						type = token::UNDEFINED;
-						text.assign(text.begin(), text.end() - 1);
-						return;
-					}
-					break;
-			}
+
+	// determine the tokens type based off its first character
+	switch(ch) {
+		case '+': set_symbol(token::OPER, PLUS);
+			break;
+		case '-': set_symbol(token::OPER, MINUS);
+			break;
+		case '*': set_symbol(token::OPER, MULTI);
+			break;
+		case '/': set_symbol(token::OPER, DIV);
+			break;
+		case '%': set_symbol(token::OPER, MOD);
+			break;
+		case '^': set_symbol(token::OPER, POW);
+			break;
+		case '&': set_symbol(token::BINARY_OPER, AND);
+			break;
+		case '|': set_symbol(token::BINARY_OPER, OR);
+			break;
+		case '$': set_symbol(token::BINARY_OPER, XOR);
+			break;
+		case '~': set_symbol(token::UNARY_OPER, NOT);
+			break;
+		case CLS_PAREN: set_symbol(token::CLOSE_PAREN, 0);
+			break;
+		case OPN_PAREN: set_symbol(token::OPEN_PAREN, 0);
+			break;
+
+		// two character symbols (<< & >>) repeat their first character
+		default: type = token::UNDEFINED;
+			buff.next();
+			if(!buff.has_next())
+				return;
+			if((ch == '<'
+					|| ch == '>')
+					&& buff.get_current() == ch) {
+				text += ch;
+				set_symbol(token::LOGICAL_OPER, ch == '<' ? LEFT_SHIFT : RIGHT_SHIFT);
+			} else
+				return;
+			break;
+	}
 
 	// advance the buffer to the next character
 	buff.next();
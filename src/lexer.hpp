@@ -21,7 +21,6 @@
 #ifndef LEX_HPP_
 #define LEX_HPP_
 
-#include <set>
 #include <string>
 #include "pb_buffer.hpp"
 #include "token.hpp"
@@ -30,45 +29,20 @@ class lexer {
 private:
 
 	unsigned int type;
+	unsigned int code;
 	std::string text;
-	std::string input;
 	pb_buffer buff;
 
 	/*
-	 * Check to see if an element exists within a set
+	 * Returns the perfect hash of a keyword's text, an index into the keyword table (a weighted sum of the
+	 * first, second & last characters & length, collision-free over the keywords)
 	 */
-	template<class T>
-	static bool contains(const std::set<T> &set, const T &element) { return set.find(element) != set.end(); }
+	static unsigned int hash_keyword(const std::string &text);
 
 	/*
-	 * Returns true if the current token is a binary operator
+	 * Returns true if a character is a digit in the given radix
 	 */
-	bool is_binary_operator(void) { return lexer::contains<std::string>(BINARY_OPER, text); }
-
-	/*
-	 * Returns true if the current token is a constant
-	 */
-	bool is_constant(void) { return lexer::contains<std::string>(CONSTANT, text); }
-
-	/*
-	 * Returns true if the current token is a function
-	 */
-	bool is_function(void) { return lexer::contains<std::string>(FUNCTION, text); }
-
-	/*
-	 * Returns true if the current token is a logical operator
-	 */
-	bool is_logical_operator(void) { return lexer::contains<std::string>(LOGICAL_OPER, text); }
-
-	/*
-	 * Returns true if the current token is an operator
-	 */
-	bool is_operator(void) { return lexer::contains<std::string>(OPER, text); }
-
-	/*
-	 * Returns true if the current token is a unary operator
-	 */
-	bool is_unary_operator(void) { return lexer::contains<std::string>(UNARY_OPER, text); }
+	static bool is_radix_digit(char ch, unsigned int base);
 
 	/*
 	 * Reads a number from the buffer
@@ -85,6 +59,11 @@ private:
 	 */
 	void remove_whitespace(void);
 
+	/*
+	 * Sets the current token's type & code
+	 */
+	void set_symbol(unsigned int type, unsigned int code) { this->type = type; this->code = code; }
+
 	/*
 	 * Reads a symbol from the buffer
 	 */
@@ -102,7 +81,6 @@ public:
 	 */
 	enum BIN_OPER { AND, OR, XOR };
 	static const std::string BINARY_OPER_DATA[];
-	static const std::set<std::string> BINARY_OPER;
 
 	/*
 	 * Close paranthesis character
@@ -114,27 +92,47 @@ public:
 	 */
 	enum CONST_OPER { E, PI, RAND };
 	static const std::string CONSTANT_OPER_DATA[];
-	static const std::set<std::string> CONSTANT;
 
 	/*
 	 * Decimal character
 	 */
 	static const char DEC = '.';
 
+	/*
+	 * Radix prefix characters (0b, 0o, 0x)
+	 */
+	static const char BIN = 'b';
+	static const char HEX = 'x';
+	static const char OCT = 'o';
+
 	/*
 	 * Function keywords
 	 */
-	enum FUNCT_OPER { ABS, ACOS, ASIN, ATAN, CEILING, COS, COSH, FACT, FIB, FLOAT, FLOOR, INT, LN, LOG2, LOG10, ROUND,
+	enum FUNCT_OPER { ABS, ACOS, ASIN, ATAN, CEILING, COS, COSH, DIGITS, FACT, FIB, FLOAT, FLOOR, INT, LN, LOG2, LOG10, ROUND,
 						SIN, SINH, SQR, SQRT, TAN, TANH };
 	static const std::string FUNCTION_OPER_DATA[];
-	static const std::set<std::string> FUNCTION;
+
+	/*
+	 * Keyword table entry (token type & index into the keyword's data array)
+	 */
+	struct keyword {
+		const char *text;
+		unsigned int type;
+		unsigned int code;
+	};
+
+	/*
+	 * Keyword table (constants, functions & the assignment keyword), indexed by a perfect hash of the
+	 * keyword text (see hash_keyword), empty slots hold NULL
+	 */
+	static const unsigned int KEYWORD_DATA_SIZE = 64;
+	static const keyword KEYWORD_DATA[];
 
 	/*
 	 * Logical operator keywords
 	 */
 	enum LOG_OPER { LEFT_SHIFT, RIGHT_SHIFT };
 	static const std::string LOGICAL_OPER_DATA[];
-	static const std::set<std::string> LOGICAL_OPER;
 
 	/*
 	 * Open parenthesis character
@@ -146,14 +144,12 @@ public:
 	 */
 	enum OPER { PLUS, MINUS, MULTI, DIV, MOD, POW };
 	static const std::string OPER_DATA[];
-	static const std::set<std::string> OPER;
 
 	/*
 	 * Unary operator keywords
 	 */
 	enum UNARY_OPER { NOT };
 	static const std::string UNARY_OPER_DATA[];
-	static const std::set<std::string> UNARY_OPER;
 
 	/*
 	 * Lexer constructor
@@ -166,10 +162,15 @@ public:
 	lexer(const lexer &other);
 
 	/*
-	 * Lexer constructor
+	 * Lexer constructor (the input is referenced, not copied, and must outlive the lexer)
 	 */
 	lexer(const std::string &input);
 
+	/*
+	 * Lexer constructor (the input is referenced, not copied, and must outlive the lexer)
+	 */
+	lexer(const char *input, size_t length);
+
 	/*
 	 * Lexer destructor
 	 */
@@ -195,6 +196,11 @@ public:
 	 */
 	unsigned int get_position(void) { return buff.get_position(); }
 
+	/*
+	 * Returns the current token code (index into the keyword data array, interned identifier or 0)
+	 */
+	unsigned int get_code(void) { return code; }
+
 	/*
 	 * Returns the contents of the lexer as a token
 	 */
@@ -0,0 +1,730 @@
+/*
+ * Cli Calc -- a small CLI calculator
+ * Copyright (C) 2012 David Jolly
+ * ----------------------
+ * This file is part of Cli Calc
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cctype>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "num_value.hpp"
+#include "par_int.hpp"
+#include "reg_pool.hpp"
+
+/*
+ * Integer output radix
+ */
+unsigned int num_value::base = 10;
+
+/*
+ * Display limit (in digits, 0 for unlimited)
+ */
+unsigned long num_value::limit = 0;
+
+/*
+ * Floating-point mode
+ */
+unsigned int num_value::mode = num_value::MULTI_PRECISION;
+
+/*
+ * Floating-point working precision (in bits)
+ */
+unsigned long num_value::precision = num_value::DEFAULT_PRECISION;
+
+/*
+ * Value constructor
+ */
+num_value::num_value(const num_value &other) : type(UNDEFINED), machine(false) {
+
+	// copy the other value
+	*this = other;
+}
+
+/*
+ * Value assignment
+ */
+num_value &num_value::operator=(const num_value &other) {
+
+	// check for self-assignment
+	if(this == &other)
+		return *this;
+
+	// copy value of the same type
+	switch(other.type) {
+		case INTEGER:
+			if(other.machine)
+				set_small(other.word);
+			else
+				mpz_set(set_integer(), other.integer);
+			break;
+		case FLOAT:
+			if(other.machine)
+				set_hardware(other.hardware);
+			else
+				mpfr_set(set_float(), other.real, GMP_RNDN);
+			break;
+		default: clear();
+			break;
+	}
+	return *this;
+}
+
+/*
+ * Value equivalence
+ */
+bool num_value::operator==(const num_value &other) {
+
+	// check for same object
+	if(this == &other)
+		return true;
+
+	// check that type & value match
+	if(type != other.type)
+		return false;
+	switch(type) {
+		case INTEGER:
+			if(machine && other.machine)
+				return word == other.word;
+			else if(machine)
+				return !mpz_cmp_si(other.integer, word);
+			else if(other.machine)
+				return !mpz_cmp_si(integer, other.word);
+			return !mpz_cmp(integer, other.integer);
+		case FLOAT:
+			if(machine && other.machine)
+				return hardware == other.hardware;
+			else if(machine)
+				return !mpfr_cmp_d(other.real, hardware);
+			else if(other.machine)
+				return !mpfr_cmp_d(real, other.hardware);
+			return !mpfr_cmp(real, other.real);
+		default: return true;
+	}
+}
+
+/*
+ * Appends the digits of a non-negative integer in the output radix
+ */
+void num_value::append_digits(std::string &str, mpz_t value) {
+
+	// convert in place (across worker threads for large values)
+	par_int::get_str(str, value, base);
+}
+
+/*
+ * Release the value, leaving it undefined
+ */
+void num_value::clear(void) {
+
+	// release resources held by the current type
+	if(!machine)
+		switch(type) {
+			case INTEGER: reg_pool::release(integer);
+				break;
+			case FLOAT: reg_pool::release(real);
+				break;
+			default:
+				break;
+		}
+	type = UNDEFINED;
+	machine = false;
+}
+
+/*
+ * Demotes a multi-precision integer to a machine-word integer (if it fits)
+ */
+void num_value::demote(void) {
+	int64_t value;
+
+	// check that the value is a multi-precision integer within range
+	if(type != INTEGER
+			|| machine
+			|| !mpz_fits_slong_p(integer))
+		return;
+	value = mpz_get_si(integer);
+	reg_pool::release(integer);
+	word = value;
+	machine = true;
+}
+
+/*
+ * Returns true if the value is an integer held exactly by a float in the current floating-point mode
+ */
+bool num_value::fits_float(void) {
+
+	// integers are exact up to the width of the mantissa
+	return type == INTEGER
+			&& get_bits() <= ((mode == HARDWARE) ? HARDWARE_BITS : precision);
+}
+
+/*
+ * Returns the number of bits in an integer's magnitude, as mpz_sizeinbase (value must be of type integer)
+ */
+size_t num_value::get_bits(void) {
+	uint64_t magnitude;
+
+	// count up to the highest set bit of a machine word
+	if(!machine)
+		return mpz_sizeinbase(integer, 2);
+	magnitude = (word < 0) ? 0 - (uint64_t) word : (uint64_t) word;
+	return magnitude ? 64 - __builtin_clzll(magnitude) : 1;
+}
+
+/*
+ * Returns the number of significant decimal digits held at the working precision
+ */
+unsigned long num_value::get_digits(void) {
+
+	// floor((bits - 1) * log10(2)), at least one digit
+	unsigned long digits = (unsigned long) ((precision - 1) * 0.30102999566398119521);
+	return digits ? digits : 1;
+}
+
+/*
+ * Returns a hash of the value (equal values hash alike, signed zeros hash apart)
+ */
+size_t num_value::get_hash(void) {
+	double real_value;
+	uint64_t bits;
+
+	// hash integers by value when they fit a word, otherwise by their low limb, size & sign
+	switch(type) {
+		case INTEGER:
+			if(machine)
+				return (size_t) word;
+			else if(mpz_fits_slong_p(integer))
+				return (size_t) mpz_get_si(integer);
+			return (size_t) mpz_getlimbn(integer, 0) ^ ((size_t) mpz_size(integer) << 1) ^ (mpz_sgn(integer) < 0);
+
+		// hash floats by the bits of their nearest double
+		case FLOAT:
+			real_value = machine ? hardware : mpfr_get_d(real, GMP_RNDN);
+			std::memcpy(&bits, &real_value, sizeof(bits));
+			return (size_t) bits;
+		default:
+			return 0;
+	}
+}
+
+/*
+ * Returns the number of digits of an integer in the output radix (value must be of type integer)
+ */
+unsigned long num_value::get_length(void) {
+	unsigned long length = 1;
+	mpz_t power;
+
+	// count machine-word digits directly
+	if(machine) {
+		uint64_t magnitude = (word < 0) ? -(uint64_t) word : word;
+		while(magnitude >= base) {
+			magnitude /= base;
+			length++;
+		}
+		return length;
+	}
+
+	// the estimated length is exact for a power-of-two radix, otherwise it may be one too long
+	length = mpz_sizeinbase(integer, base);
+	if(base == 10
+			&& length > 1) {
+		reg_pool::acquire(power);
+		mpz_ui_pow_ui(power, base, length - 1);
+		if(mpz_cmpabs(integer, power) < 0)
+			length--;
+		reg_pool::release(power);
+	}
+	return length;
+}
+
+/*
+ * Returns the value as a float (value must be of type float)
+ */
+mpfr_t &num_value::get_float(void) {
+
+	// promote hardware floats, round floats held at a previous precision
+	if(machine)
+		promote();
+	else if(mpfr_get_prec(real) != (mpfr_prec_t) precision)
+		mpfr_prec_round(real, precision, GMP_RNDN);
+	return real;
+}
+
+/*
+ * Negates the value if possible
+ */
+bool num_value::negate(void) {
+
+	// negate the value if of type integer or float
+	if(type == INTEGER) {
+		if(machine
+				&& word != INT64_MIN)
+			word = -word;
+		else
+			mpz_neg(get_integer(), get_integer());
+	} else if(type == FLOAT) {
+		if(machine)
+			hardware = -hardware;
+		else
+			mpfr_neg(real, real, GMP_RNDN);
+	} else
+		return false;
+	return true;
+}
+
+/*
+ * Sets the value from a string of the given type (integers may carry a 0b, 0o or 0x prefix)
+ */
+bool num_value::parse(const std::string &text, unsigned int type) {
+	unsigned int radix = 0, shift = 0;
+
+	// check if string is empty
+	if(text.empty())
+		return false;
+
+	// convert the string once into the appropriate type (short integers fit in a word)
+	if(type == INTEGER) {
+
+		// power-of-two radix integers convert in linear time (up to 62 bits fit in a word)
+		if(text.size() > 2
+				&& text.at(0) == '0') {
+			switch(text.at(1)) {
+				case 'b': radix = 2; shift = 1;
+					break;
+				case 'o': radix = 8; shift = 3;
+					break;
+				case 'x': radix = 16; shift = 4;
+					break;
+				default:
+					break;
+			}
+		}
+		if(radix) {
+			if((text.size() - 2) * shift < 63) {
+				int64_t value = 0;
+				for(std::string::const_iterator i = text.begin() + 2; i != text.end(); ++i) {
+					unsigned int digit = isdigit(*i) ? *i - '0' : (isxdigit(*i) ? (tolower(*i) - 'a') + 10 : radix);
+					if(digit >= radix)
+						return false;
+					value = (value << shift) | digit;
+				}
+				set_small(value);
+				return true;
+			} else if(mpz_set_str(set_integer(), text.c_str() + 2, radix))
+				return false;
+			demote();
+			return true;
+		} else if(text.size() < DIGITS10) {
+			int64_t value = 0;
+			for(std::string::const_iterator i = text.begin(); i != text.end(); ++i) {
+				if(!isdigit(*i))
+					return false;
+				value = (value * 10) + (*i - '0');
+			}
+			set_small(value);
+			return true;
+		} else if(!par_int::set_str(set_integer(), text, 10))
+			return false;
+		demote();
+		return true;
+	} else if(type == FLOAT) {
+
+		// parse into hardware, unless the literal is out of range
+		if(mode == HARDWARE) {
+			double value = strtod(text.c_str(), NULL);
+			if(std::isfinite(value)) {
+				set_hardware(value);
+				return true;
+			}
+		}
+		return !mpfr_set_str(set_float(), text.c_str(), 10, GMP_RNDN);
+	}
+	clear();
+	return false;
+}
+
+/*
+ * Promotes a machine-word integer or hardware float to multi-precision
+ */
+void num_value::promote(void) {
+	int64_t value = word;
+	double hw_value = hardware;
+
+	// move the word into a newly initialized integer or float
+	if(type == INTEGER) {
+		reg_pool::acquire(integer);
+		mpz_set_si(integer, value);
+	} else {
+		reg_pool::acquire(real, precision);
+		mpfr_set_d(real, hw_value, GMP_RNDN);
+	}
+	machine = false;
+}
+
+/*
+ * Appends a summary of a non-negative integer longer than the display limit (leading
+ * digits, trailing digits & length), returning false if the integer is within the limit
+ */
+bool num_value::summarize(std::string &str) {
+	char buf[DIGITS10 + 2];
+	size_t prefix;
+	mpz_t part, power;
+	unsigned long length = mpz_sizeinbase(integer, base), trail = limit / 2, lead = limit - trail;
+
+	// check the estimated length first (only the displayed digits are ever converted)
+	if(length <= limit)
+		return false;
+	reg_pool::acquire(part);
+	reg_pool::acquire(power);
+
+	// divide off all but the leading digits, plus one (the estimated length may be one too long)
+	mpz_ui_pow_ui(power, base, length - lead - 1);
+	mpz_tdiv_q(part, integer, power);
+	mpz_ui_pow_ui(power, base, lead);
+	if(mpz_cmp(part, power) >= 0)
+		mpz_tdiv_q_ui(part, part, base);
+	else if(--length <= limit) {
+		reg_pool::release(part);
+		reg_pool::release(power);
+		return false;
+	}
+	append_digits(str, part);
+	str += "...";
+
+	// trailing digits are the remainder, padded with leading zeros
+	if(trail) {
+		mpz_ui_pow_ui(power, base, trail);
+		mpz_tdiv_r(part, integer, power);
+		prefix = str.size();
+		append_digits(str, part);
+		str.insert(prefix, trail - (str.size() - prefix), '0');
+	}
+	snprintf(buf, sizeof(buf), "%lu", length);
+	str += " (";
+	str += buf;
+	str += " digits)";
+	reg_pool::release(part);
+	reg_pool::release(power);
+	return true;
+}
+
+/*
+ * Sets the integer output radix (2, 8, 10 or 16)
+ */
+bool num_value::set_base(unsigned int base) {
+
+	// check that the radix is supported
+	if(base != 2
+			&& base != 8
+			&& base != 10
+			&& base != 16)
+		return false;
+	num_value::base = base;
+	return true;
+}
+
+/*
+ * Initializes the value as a float, returning the float
+ */
+mpfr_t &num_value::set_float(void) {
+
+	// reuse an existing float, otherwise initialize a new one
+	if(type != FLOAT
+			|| machine) {
+		clear();
+		reg_pool::acquire(real, precision);
+		type = FLOAT;
+	} else if(mpfr_get_prec(real) != (mpfr_prec_t) precision)
+		mpfr_set_prec(real, precision);
+	return real;
+}
+
+/*
+ * Sets the value to a hardware float
+ */
+void num_value::set_hardware(double value) {
+
+	// release any multi-precision value
+	if(!machine)
+		clear();
+	type = FLOAT;
+	machine = true;
+	hardware = value;
+}
+
+/*
+ * Initializes the value as an integer, returning the integer
+ */
+mpz_t &num_value::set_integer(void) {
+
+	// reuse an existing integer, otherwise initialize a new one
+	if(type != INTEGER
+			|| machine) {
+		clear();
+		reg_pool::acquire(integer);
+		type = INTEGER;
+	}
+	return integer;
+}
+
+/*
+ * Sets the floating-point working precision (in bits)
+ */
+bool num_value::set_precision(unsigned long bits) {
+
+	// check that the precision is within libmpfr limits
+	if(bits < MPFR_PREC_MIN
+			|| bits > (unsigned long) MPFR_PREC_MAX)
+		return false;
+	precision = bits;
+	return true;
+}
+
+/*
+ * Sets the value to a machine-word integer
+ */
+void num_value::set_small(int64_t value) {
+
+	// release any multi-precision value
+	if(!machine)
+		clear();
+	type = INTEGER;
+	machine = true;
+	word = value;
+}
+
+/*
+ * Exchange the contents of two values
+ */
+void num_value::swap(num_value &other) {
+	unsigned int tmp_type = type;
+	bool tmp_machine = machine;
+	char tmp[sizeof(mpfr_t)];
+
+	// exchange the raw contents (the float is the largest union member, copy
+	// bytewise so that an integer overlapping struct padding is carried intact)
+	memcpy(tmp, real, sizeof(mpfr_t));
+	memcpy(real, other.real, sizeof(mpfr_t));
+	memcpy(other.real, tmp, sizeof(mpfr_t));
+	type = other.type;
+	machine = other.machine;
+	other.type = tmp_type;
+	other.machine = tmp_machine;
+}
+
+/*
+ * Converts the value to a float (if it is an integer), in the current floating-point mode
+ */
+bool num_value::to_float(void) {
+	mpfr_t value;
+
+	// floats are left untouched
+	if(type == FLOAT)
+		return true;
+	else if(type != INTEGER)
+		return false;
+
+	// convert the integer into a hardware float (if in range)
+	if(mode == HARDWARE) {
+		double hw_value = machine ? (double) word : mpz_get_d(integer);
+		if(std::isfinite(hw_value)) {
+			set_hardware(hw_value);
+			return true;
+		}
+	}
+
+	// convert the integer into a float
+	reg_pool::acquire(value, precision);
+	if(machine)
+		mpfr_set_si(value, word, GMP_RNDN);
+	else {
+		mpfr_set_z(value, integer, GMP_RNDN);
+		reg_pool::release(integer);
+	}
+	memcpy(real, value, sizeof(mpfr_t));
+	type = FLOAT;
+	machine = false;
+	return true;
+}
+
+/*
+ * Returns a string representation of the value (integers in the output radix)
+ */
+void num_value::to_string(std::string &str) {
+	char *tmp = NULL;
+	char buf[DIGITS10 + HARDWARE_DIGITS10];
+	unsigned long digits;
+	bool negative;
+
+	// convert value to a string
+	switch(type) {
+		case INTEGER:
+			if(machine
+					&& base == 10
+					&& (!limit || limit >= DIGITS10)) {
+				snprintf(buf, sizeof(buf), "%" PRId64, word);
+				str.assign(buf);
+				break;
+			} else if(machine)
+				promote();
+
+			// prefix power-of-two radix output (0b, 0o, 0x), so that it reads back as input
+			negative = mpz_sgn(integer) < 0;
+			str.assign(negative ? "-" : "");
+			if(base != 10) {
+				str += '0';
+				str += (base == 2) ? 'b' : ((base == 8) ? 'o' : 'x');
+			}
+
+			// convert the magnitude, or summarize it if longer than the display limit
+			if(negative)
+				mpz_neg(integer, integer);
+			if(!limit
+					|| !summarize(str))
+				append_digits(str, integer);
+			if(negative)
+				mpz_neg(integer, integer);
+			demote();
+			break;
+		case FLOAT:
+
+			// floats longer than the display limit are shown with fewer significant digits
+			digits = machine ? HARDWARE_DIGITS10 : get_digits();
+			if(limit
+					&& limit < digits)
+				digits = limit;
+			if(machine) {
+				snprintf(buf, sizeof(buf), "%.*g", (int) digits, hardware);
+				str.assign(buf);
+			} else if(mpfr_asprintf(&tmp, "%.*Rg", (int) digits, real) < 0)
+				str.assign("0.0");
+			else {
+				str.assign(tmp);
+				mpfr_free_str(tmp);
+			}
+			break;
+		default: str.clear();
+			break;
+	}
+}
+
+/*
+ * Writes the digits of a non-negative integer below powers[level]^2 in the output radix,
+ * dividing by successive powers so only a single chunk of digits is formatted at a time
+ * (pad gives the number of digits, including leading zeros, or 0 for leading digits)
+ */
+void num_value::stream_digits(std::ostream &stream, mpz_t value, int level, std::vector<__mpz_struct> &powers,
+		unsigned long pad) {
+	mpz_t high, low;
+	std::string str;
+
+	// format a single chunk, padded with leading zeros
+	if(level < 0) {
+		if(pad
+				|| mpz_sgn(value))
+			append_digits(str, value);
+		if(str.size() < pad)
+			str.insert(0, pad - str.size(), '0');
+		stream.write(str.data(), str.size());
+		return;
+	}
+
+	// split the value into high & low digits (low digits are padded, unless they lead)
+	reg_pool::acquire(high);
+	reg_pool::acquire(low);
+	mpz_tdiv_qr(high, low, value, &powers[level]);
+	if(pad
+			|| mpz_sgn(high)) {
+		stream_digits(stream, high, level - 1, powers, pad ? pad - (CHUNK_DIGITS << level) : 0);
+		pad = CHUNK_DIGITS << level;
+	}
+	reg_pool::release(high);
+	stream_digits(stream, low, level - 1, powers, pad);
+	reg_pool::release(low);
+}
+
+/*
+ * Writes the value to a stream, large integers are written in chunks as they are converted
+ */
+bool num_value::write(std::ostream &stream) {
+	int level;
+	mpz_t high, low;
+	std::string str;
+	std::vector<__mpz_struct> powers;
+	unsigned long pad = 0;
+	size_t bits;
+	bool negative;
+
+	// small values, floats & summaries are formatted whole, as are large values converted
+	// across worker threads (trading the memory of the digits for conversion speed)
+	if(type != INTEGER
+			|| machine
+			|| mpz_sizeinbase(integer, base) <= CHUNK_DIGITS
+			|| (limit && mpz_sizeinbase(integer, base) > limit)
+			|| (par_int::get_threads() > 1 && mpz_sizeinbase(integer, base) >= par_int::STR_THRESHOLD)) {
+		to_string(str);
+		if(str.empty())
+			return false;
+		stream.write(str.data(), str.size());
+		return true;
+	}
+
+	// square powers of the radix (base^CHUNK_DIGITS, base^(2 * CHUNK_DIGITS), ...) until the
+	// square of the last power exceeds the value
+	bits = mpz_sizeinbase(integer, 2);
+	powers.resize(1);
+	mpz_init(&powers.back());
+	mpz_ui_pow_ui(&powers.back(), base, CHUNK_DIGITS);
+	while((mpz_sizeinbase(&powers.back(), 2) - 1) * 2 < bits) {
+		powers.resize(powers.size() + 1);
+		mpz_init(&powers.back());
+		mpz_mul(&powers.back(), &powers[powers.size() - 2], &powers[powers.size() - 2]);
+	}
+
+	// write the sign & radix prefix, followed by the magnitude
+	negative = mpz_sgn(integer) < 0;
+	if(negative)
+		stream.put('-');
+	if(base != 10) {
+		stream.put('0');
+		stream.put((base == 2) ? 'b' : ((base == 8) ? 'o' : 'x'));
+	}
+	if(negative)
+		mpz_neg(integer, integer);
+
+	// split off the high digits, the largest power is only needed once
+	reg_pool::acquire(high);
+	reg_pool::acquire(low);
+	level = powers.size() - 1;
+	mpz_tdiv_qr(high, low, integer, &powers[level]);
+	if(negative)
+		mpz_neg(integer, integer);
+	mpz_clear(&powers.back());
+	powers.pop_back();
+	if(mpz_sgn(high)) {
+		stream_digits(stream, high, level - 1, powers, 0);
+		pad = CHUNK_DIGITS << level;
+	}
+	reg_pool::release(high);
+	stream_digits(stream, low, level - 1, powers, pad);
+	reg_pool::release(low);
+	for(std::vector<__mpz_struct>::iterator i = powers.begin(); i != powers.end(); ++i)
+		mpz_clear(&*i);
+	return true;
+}
@@ -0,0 +1,326 @@
+/*
+ * Cli Calc -- a small CLI calculator
+ * Copyright (C) 2012 David Jolly
+ * ----------------------
+ * This file is part of Cli Calc
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NUM_VALUE_HPP_
+#define NUM_VALUE_HPP_
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <gmp.h>
+#include <mpfr.h>
+
+class num_value {
+private:
+
+	unsigned int type;
+	bool machine;
+	union {
+		int64_t word;
+		double hardware;
+		mpz_t integer;
+		mpfr_t real;
+	};
+
+	/*
+	 * Integer output radix
+	 */
+	static unsigned int base;
+
+	/*
+	 * Display limit (in digits, 0 for unlimited)
+	 */
+	static unsigned long limit;
+
+	/*
+	 * Floating-point mode
+	 */
+	static unsigned int mode;
+
+	/*
+	 * Floating-point working precision (in bits)
+	 */
+	static unsigned long precision;
+
+	/*
+	 * Appends the digits of a non-negative integer in the output radix
+	 */
+	static void append_digits(std::string &str, mpz_t value);
+
+	/*
+	 * Promotes a machine-word integer or hardware float to multi-precision
+	 */
+	void promote(void);
+
+	/*
+	 * Writes the digits of a non-negative integer below powers[level]^2 in the output radix,
+	 * dividing by successive powers so only a single chunk of digits is formatted at a time
+	 * (pad gives the number of digits, including leading zeros, or 0 for leading digits)
+	 */
+	static void stream_digits(std::ostream &stream, mpz_t value, int level, std::vector<__mpz_struct> &powers,
+			unsigned long pad);
+
+	/*
+	 * Appends a summary of a non-negative integer longer than the display limit (leading
+	 * digits, trailing digits & length), returning false if the integer is within the limit
+	 */
+	bool summarize(std::string &str);
+
+public:
+
+	/*
+	 * Value types
+	 */
+	enum TYPE { UNDEFINED, INTEGER, FLOAT };
+
+	/*
+	 * Floating-point modes
+	 */
+	enum MODE { MULTI_PRECISION, HARDWARE };
+
+	/*
+	 * Number of digits formatted at a time when writing a large integer
+	 */
+	static const unsigned long CHUNK_DIGITS = 1 << 14;
+
+	/*
+	 * Number of decimal digits displayed for a hardware float
+	 */
+	static const unsigned int HARDWARE_DIGITS10 = 15;
+
+	/*
+	 * Number of mantissa bits in a hardware float
+	 */
+	static const unsigned long HARDWARE_BITS = 53;
+
+	/*
+	 * Maximum number of decimal digits in a machine-word integer
+	 */
+	static const unsigned int DIGITS10 = 19;
+
+	/*
+	 * Default floating-point working precision (in bits)
+	 */
+	static const unsigned long DEFAULT_PRECISION = 70;
+
+	/*
+	 * Value constructor
+	 */
+	num_value(void) : type(UNDEFINED), machine(false) { return; }
+
+	/*
+	 * Value constructor
+	 */
+	num_value(const num_value &other);
+
+	/*
+	 * Value destructor
+	 */
+	virtual ~num_value(void) { clear(); }
+
+	/*
+	 * Value assignment
+	 */
+	num_value &operator=(const num_value &other);
+
+	/*
+	 * Value equivalence
+	 */
+	bool operator==(const num_value &other);
+
+	/*
+	 * Value equivalence
+	 */
+	bool operator!=(const num_value &other) { return !(*this == other); }
+
+	/*
+	 * Release the value, leaving it undefined
+	 */
+	void clear(void);
+
+	/*
+	 * Demotes a multi-precision integer to a machine-word integer (if it fits)
+	 */
+	void demote(void);
+
+	/*
+	 * Returns true if the value is an integer held exactly by a float in the current floating-point mode
+	 */
+	bool fits_float(void);
+
+	/*
+	 * Returns the value as an integer (value must be of type integer)
+	 */
+	mpz_t &get_integer(void) { if(machine) promote(); return integer; }
+
+	/*
+	 * Returns the value as a float (value must be of type float)
+	 */
+	mpfr_t &get_float(void);
+
+	/*
+	 * Returns the integer output radix
+	 */
+	static unsigned int get_base(void) { return base; }
+
+	/*
+	 * Returns the number of bits in an integer's magnitude, as mpz_sizeinbase (value must be of type integer)
+	 */
+	size_t get_bits(void);
+
+	/*
+	 * Returns the number of significant decimal digits held at the working precision
+	 */
+	static unsigned long get_digits(void);
+
+	/*
+	 * Returns a hash of the value (equal values hash alike, signed zeros hash apart)
+	 */
+	size_t get_hash(void);
+
+	/*
+	 * Returns the value as a hardware float (value must be a hardware float)
+	 */
+	double get_hardware(void) { return hardware; }
+
+	/*
+	 * Returns the number of digits of an integer in the output radix (value must be of type integer)
+	 */
+	unsigned long get_length(void);
+
+	/*
+	 * Returns the display limit (in digits, 0 for unlimited)
+	 */
+	static unsigned long get_limit(void) { return limit; }
+
+	/*
+	 * Returns the floating-point mode
+	 */
+	static unsigned int get_mode(void) { return mode; }
+
+	/*
+	 * Returns the floating-point working precision (in bits)
+	 */
+	static unsigned long get_precision(void) { return precision; }
+
+	/*
+	 * Returns the value as a machine-word integer (value must be a small integer)
+	 */
+	int64_t get_small(void) { return word; }
+
+	/*
+	 * Returns the value's type
+	 */
+	unsigned int get_type(void) { return type; }
+
+	/*
+	 * Returns true if the value is of type float
+	 */
+	bool is_float(void) { return type == FLOAT; }
+
+	/*
+	 * Returns true if the value is of type integer
+	 */
+	bool is_integer(void) { return type == INTEGER; }
+
+	/*
+	 * Returns true if the value is a float held in hardware (double-precision)
+	 */
+	bool is_hardware(void) { return machine && type == FLOAT; }
+
+	/*
+	 * Returns true if the value is an integer held in a machine word
+	 */
+	bool is_small(void) { return machine && type == INTEGER; }
+
+	/*
+	 * Negates the value if possible
+	 */
+	bool negate(void);
+
+	/*
+	 * Sets the value from a string of the given type (integers may carry a 0b, 0o or 0x prefix)
+	 */
+	bool parse(const std::string &text, unsigned int type);
+
+	/*
+	 * Sets the integer output radix (2, 8, 10 or 16)
+	 */
+	static bool set_base(unsigned int base);
+
+	/*
+	 * Initializes the value as a float, returning the float
+	 */
+	mpfr_t &set_float(void);
+
+	/*
+	 * Sets the value to a hardware float
+	 */
+	void set_hardware(double value);
+
+	/*
+	 * Initializes the value as an integer, returning the integer
+	 */
+	mpz_t &set_integer(void);
+
+	/*
+	 * Sets the display limit (in digits, 0 for unlimited)
+	 */
+	static void set_limit(unsigned long limit) { num_value::limit = limit; }
+
+	/*
+	 * Sets the floating-point mode
+	 */
+	static void set_mode(unsigned int mode) { num_value::mode = mode; }
+
+	/*
+	 * Sets the floating-point working precision (in bits)
+	 */
+	static bool set_precision(unsigned long bits);
+
+	/*
+	 * Sets the value to a machine-word integer
+	 */
+	void set_small(int64_t value);
+
+	/*
+	 * Exchange the contents of two values
+	 */
+	void swap(num_value &other);
+
+	/*
+	 * Converts the value to a float (if it is an integer), in the current floating-point mode
+	 */
+	bool to_float(void);
+
+	/*
+	 * Writes the value to a stream, large integers are written in chunks as they are converted
+	 */
+	bool write(std::ostream &stream);
+
+	/*
+	 * Returns a string representation of the value (integers in the output radix), summarizing
+	 * values longer than the display limit
+	 */
+	void to_string(std::string &str);
+};
+
+#endif
@@ -0,0 +1,449 @@
+/*
+ * Cli Calc -- a small CLI calculator
+ * Copyright (C) 2012 David Jolly
+ * ----------------------
+ * This file is part of Cli Calc
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <system_error>
+#include <thread>
+#include "par_int.hpp"
+
+/*
+ * Number of worker threads
+ */
+unsigned int par_int::threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+/*
+ * Computes a factorial, in parallel above the size threshold (as a product of prime powers)
+ */
+void par_int::fac(mpz_t result, unsigned long value) {
+	unsigned long twos = 0;
+	std::vector<bool> composite;
+	std::vector<unsigned long> exponents;
+	std::vector<std::vector<unsigned long> > factors;
+	mpz_t part;
+
+	// small factorials, or a single thread, are left to libgmp
+	if(threads == 1
+			|| value < FAC_THRESHOLD) {
+		mpz_fac_ui(result, value);
+		return;
+	}
+
+	// the power of two is applied last as a shift (legendre: sum of value / 2^i)
+	for(unsigned long power = value / 2; power; power /= 2)
+		twos += power;
+
+	// sieve odd primes, sorting each into the factors of the exponent bits it sets
+	composite.resize(value / 2 + 1);
+	for(unsigned long prime = 3; prime <= value; prime += 2) {
+		unsigned long exponent = 0;
+		if(composite[prime / 2])
+			continue;
+		if(prime <= value / prime)
+			for(unsigned long multiple = prime * prime; multiple <= value; multiple += 2 * prime)
+				composite[multiple / 2] = true;
+		for(unsigned long power = value / prime; power; power /= prime)
+			exponent += power;
+		for(size_t bit = 0; exponent; bit++, exponent >>= 1) {
+			if(factors.size() <= bit)
+				factors.resize(bit + 1);
+			if(exponent & 1)
+				factors.at(bit).push_back(prime);
+		}
+	}
+	composite.clear();
+
+	// combine by exponent bit, highest first: result = (result^2) * product(bit)
+	mpz_set_ui(result, 1);
+	mpz_init(part);
+	for(size_t bit = factors.size(); bit--;) {
+		mul(result, result, result);
+		product_split(part, factors.at(bit));
+		mul(result, result, part);
+		factors.at(bit).clear();
+	}
+	mpz_clear(part);
+	mpz_mul_2exp(result, result, twos);
+}
+
+/*
+ * Returns the depth to which a multiply may split, given a number of concurrent tasks
+ */
+unsigned int par_int::get_depth(unsigned int tasks) {
+	unsigned int depth = 0;
+
+	// each karatsuba split runs three products, split while every thread has one
+	for(tasks *= 3; tasks <= threads; tasks *= 3)
+		depth++;
+	return depth;
+}
+
+/*
+ * Appends the digits of a non-negative integer in a given radix, in parallel above the size threshold
+ */
+void par_int::get_str(std::string &str, const mpz_t value, int base) {
+	unsigned int level = 0;
+	size_t prefix = str.size(), width = mpz_sizeinbase(value, base), leaf;
+	std::vector<__mpz_struct> powers;
+
+	// split in half once per level, until every thread has a field to convert
+	for(unsigned int tasks = 2; tasks <= threads; tasks *= 2)
+		level++;
+
+	// small values, or a single thread, are left to libgmp (size may overestimate by one digit, plus null)
+	if(!level
+			|| width < STR_THRESHOLD) {
+		str.resize(prefix + width + 1);
+		mpz_get_str(&str[prefix], base, value);
+		str.resize(strlen(str.c_str()));
+		return;
+	}
+
+	// square powers of the radix up from the leaf field width (base^leaf, base^(2 * leaf), ...)
+	leaf = (width + (1 << level) - 1) >> level;
+	powers.resize(level);
+	mpz_init(&powers.front());
+	mpz_ui_pow_ui(&powers.front(), base, leaf);
+	for(size_t i = 1; i < powers.size(); i++) {
+		mpz_init(&powers.at(i));
+		mpz_mul(&powers.at(i), &powers.at(i - 1), &powers.at(i - 1));
+	}
+
+	// convert into a field of the estimated width, removing the leading zero if the estimate was one too long
+	str.resize(prefix + width);
+	get_str_split(&str[prefix], width, value, base, powers, leaf, level);
+	if(width > 1
+			&& str.at(prefix) == '0')
+		str.erase(prefix, 1);
+	for(std::vector<__mpz_struct>::iterator i = powers.begin(); i != powers.end(); ++i)
+		mpz_clear(&*i);
+}
+
+/*
+ * Converts a non-negative integer below base^width into a fixed-width field of digits (padded
+ * with leading zeros), splitting by powers[level - 1] and converting both halves in parallel
+ */
+void par_int::get_str_split(char *digits, size_t width, mpz_srcptr value, int base, const std::vector<__mpz_struct> &powers,
+		size_t leaf, unsigned int level) {
+	mpz_t high, low;
+	size_t split, size;
+	std::vector<char> buffer;
+	std::vector<std::function<void(void)> > tasks;
+
+	// convert a leaf field whole, right-aligned
+	if(!level) {
+		buffer.resize(mpz_sizeinbase(value, base) + 2);
+		mpz_get_str(&buffer.front(), base, value);
+		size = strlen(&buffer.front());
+		memset(digits, '0', width - size);
+		memcpy(digits + (width - size), &buffer.front(), size);
+		return;
+	}
+
+	// fields no wider than the split descend a level unsplit
+	split = leaf << (level - 1);
+	if(width <= split) {
+		get_str_split(digits, width, value, base, powers, leaf, level - 1);
+		return;
+	}
+
+	// split into high & low fields, converting both in parallel
+	mpz_init(high);
+	mpz_init(low);
+	mpz_tdiv_qr(high, low, value, &powers.at(level - 1));
+	tasks.push_back(std::bind(get_str_split, digits, width - split, high, base, std::cref(powers), leaf, level - 1));
+	tasks.push_back(std::bind(get_str_split, digits + (width - split), split, low, base, std::cref(powers), leaf, level - 1));
+	run(tasks);
+	mpz_clear(high);
+	mpz_clear(low);
+}
+
+/*
+ * Multiplies (or squares) two integers, in parallel above the size threshold
+ */
+void par_int::mul(mpz_t result, const mpz_t first, const mpz_t second) {
+	mul_split(result, first, second, get_depth(1));
+}
+
+/*
+ * Multiplies two integers, splitting the operands across threads to a given depth
+ * (karatsuba for balanced operands, halving the larger operand otherwise)
+ */
+void par_int::mul_split(mpz_ptr result, mpz_srcptr first, mpz_srcptr second, unsigned int depth) {
+	mp_bitcnt_t half;
+	mpz_t high, low, first_sum, second_sum, high_prod, low_prod, mid_prod;
+	std::vector<std::function<void(void)> > tasks;
+	size_t first_size = mpz_size(first), second_size = mpz_size(second);
+
+	// multiply sequentially at the bottom of the split, or below the threshold
+	if(!depth
+			|| std::min(first_size, second_size) < MUL_THRESHOLD) {
+		mpz_mul(result, first, second);
+		return;
+	}
+	mpz_init(high_prod);
+	mpz_init(low_prod);
+
+	// unbalanced operands: multiply both halves of the larger operand by the smaller
+	if(first_size >= 2 * second_size
+			|| second_size >= 2 * first_size) {
+		if(first_size < second_size) {
+			std::swap(first, second);
+			std::swap(first_size, second_size);
+		}
+		half = (first_size / 2) * GMP_NUMB_BITS;
+		mpz_init(high);
+		mpz_init(low);
+		mpz_tdiv_q_2exp(high, first, half);
+		mpz_tdiv_r_2exp(low, first, half);
+		tasks.push_back(std::bind(mul_split, high_prod, high, second, depth - 1));
+		tasks.push_back(std::bind(mul_split, low_prod, low, second, depth - 1));
+		run(tasks);
+		mpz_clear(high);
+		mpz_clear(low);
+
+		// combine as high * 2^half + low
+		mpz_mul_2exp(high_prod, high_prod, half);
+		mpz_add(result, high_prod, low_prod);
+		mpz_clear(high_prod);
+		mpz_clear(low_prod);
+		return;
+	}
+
+	// balanced operands: split both operands in half (signed halves keep the identity exact)
+	half = (std::max(first_size, second_size) / 2) * GMP_NUMB_BITS;
+	mpz_init(high);
+	mpz_init(low);
+	mpz_init(first_sum);
+	mpz_init(mid_prod);
+	mpz_tdiv_q_2exp(high, first, half);
+	mpz_tdiv_r_2exp(low, first, half);
+	mpz_add(first_sum, high, low);
+
+	// squares split a single operand
+	if(first == second) {
+		tasks.push_back(std::bind(mul_split, high_prod, high, high, depth - 1));
+		tasks.push_back(std::bind(mul_split, low_prod, low, low, depth - 1));
+		tasks.push_back(std::bind(mul_split, mid_prod, first_sum, first_sum, depth - 1));
+		run(tasks);
+	} else {
+		mpz_t second_high, second_low;
+		mpz_init(second_high);
+		mpz_init(second_low);
+		mpz_init(second_sum);
+		mpz_tdiv_q_2exp(second_high, second, half);
+		mpz_tdiv_r_2exp(second_low, second, half);
+		mpz_add(second_sum, second_high, second_low);
+		tasks.push_back(std::bind(mul_split, high_prod, high, second_high, depth - 1));
+		tasks.push_back(std::bind(mul_split, low_prod, low, second_low, depth - 1));
+		tasks.push_back(std::bind(mul_split, mid_prod, first_sum, second_sum, depth - 1));
+		run(tasks);
+		mpz_clear(second_high);
+		mpz_clear(second_low);
+		mpz_clear(second_sum);
+	}
+	mpz_clear(high);
+	mpz_clear(low);
+	mpz_clear(first_sum);
+
+	// combine as high * 2^(2 * half) + (mid - high - low) * 2^half + low
+	mpz_sub(mid_prod, mid_prod, high_prod);
+	mpz_sub(mid_prod, mid_prod, low_prod);
+	mpz_mul_2exp(high_prod, high_prod, 2 * half);
+	mpz_mul_2exp(mid_prod, mid_prod, half);
+	mpz_add(high_prod, high_prod, mid_prod);
+	mpz_add(result, high_prod, low_prod);
+	mpz_clear(high_prod);
+	mpz_clear(low_prod);
+	mpz_clear(mid_prod);
+}
+
+/*
+ * Multiplies a range of word-sized factors as a product tree
+ */
+void par_int::product(mpz_ptr result, const std::vector<unsigned long> &factors, size_t begin, size_t end) {
+	mpz_t high;
+
+	// multiply short ranges directly
+	if(end - begin <= 16) {
+		mpz_set_ui(result, 1);
+		for(size_t i = begin; i < end; i++)
+			mpz_mul_ui(result, result, factors.at(i));
+		return;
+	}
+
+	// multiply both halves, keeping operands balanced
+	mpz_init(high);
+	product(high, factors, (begin + end) / 2, end);
+	product(result, factors, begin, (begin + end) / 2);
+	mpz_mul(result, result, high);
+	mpz_clear(high);
+}
+
+/*
+ * Multiplies a series of word-sized factors, spreading subtrees of the product tree across threads
+ */
+void par_int::product_split(mpz_t result, const std::vector<unsigned long> &factors) {
+	size_t count = std::min<size_t>(threads, std::max<size_t>(factors.size() / 16, 1));
+	std::vector<__mpz_struct> parts(count);
+	std::vector<std::function<void(void)> > tasks;
+
+	// multiply an equal share of the factors on each thread
+	for(size_t i = 0; i < count; i++) {
+		mpz_init(&parts.at(i));
+		tasks.push_back(std::bind(product, &parts.at(i), std::cref(factors), (factors.size() * i) / count,
+				(factors.size() * (i + 1)) / count));
+	}
+	run(tasks);
+
+	// combine neighbouring parts pairwise, in parallel, until one remains
+	while(parts.size() > 1) {
+		size_t pairs = parts.size() / 2;
+		std::vector<__mpz_struct> combined(pairs);
+		tasks.clear();
+		for(size_t i = 0; i < pairs; i++) {
+			mpz_init(&combined.at(i));
+			tasks.push_back(std::bind(mul_split, &combined.at(i), &parts.at(2 * i), &parts.at((2 * i) + 1), get_depth(pairs)));
+		}
+		run(tasks);
+		for(size_t i = 0; i < 2 * pairs; i++)
+			mpz_clear(&parts.at(i));
+
+		// an odd part is carried up unchanged
+		if(parts.size() % 2)
+			combined.push_back(parts.back());
+		parts.swap(combined);
+	}
+	mpz_swap(result, &parts.front());
+	mpz_clear(&parts.front());
+}
+
+/*
+ * Runs a series of tasks in parallel, the last on the calling thread (tasks
+ * run sequentially if no threads can be started)
+ */
+void par_int::run(std::vector<std::function<void(void)> > &tasks) {
+	std::vector<std::thread> workers;
+
+	// start a thread for all but the last task
+	if(threads > 1)
+		for(size_t i = 0; i + 1 < tasks.size(); i++)
+			try {
+				workers.push_back(std::thread(tasks.at(i)));
+			} catch(std::system_error &) {
+				break;
+			}
+
+	// run the remaining tasks on this thread, then wait for the workers
+	for(size_t i = workers.size(); i < tasks.size(); i++)
+		tasks.at(i)();
+	for(std::vector<std::thread>::iterator i = workers.begin(); i != workers.end(); ++i)
+		i->join();
+}
+
+/*
+ * Sets an integer from a string of digits in a given radix, in parallel above the size threshold
+ * (returns false if a digit is invalid)
+ */
+bool par_int::set_str(mpz_t result, const std::string &digits, int base) {
+	unsigned int level = 0;
+	size_t width = digits.size(), leaf;
+	std::vector<__mpz_struct> powers;
+
+	// split in half once per level, until every thread has a field to parse
+	for(unsigned int tasks = 2; tasks <= threads; tasks *= 2)
+		level++;
+
+	// small values, or a single thread, are left to libgmp
+	if(!level
+			|| width < STR_THRESHOLD)
+		return !mpz_set_str(result, digits.c_str(), base);
+
+	// validate up front, so fields parsed in parallel cannot fail
+	for(std::string::const_iterator i = digits.begin(); i != digits.end(); ++i) {
+		int digit = isdigit(*i) ? *i - '0' : (isalpha(*i) ? (tolower(*i) - 'a') + 10 : base);
+		if(digit >= base)
+			return false;
+	}
+
+	// square powers of the radix up from the leaf field width (base^leaf, base^(2 * leaf), ...)
+	leaf = (width + (1 << level) - 1) >> level;
+	powers.resize(level);
+	mpz_init(&powers.front());
+	mpz_ui_pow_ui(&powers.front(), base, leaf);
+	for(size_t i = 1; i < powers.size(); i++) {
+		mpz_init(&powers.at(i));
+		mpz_mul(&powers.at(i), &powers.at(i - 1), &powers.at(i - 1));
+	}
+	set_str_split(result, digits.data(), width, base, powers, leaf, level, 1);
+	for(std::vector<__mpz_struct>::iterator i = powers.begin(); i != powers.end(); ++i)
+		mpz_clear(&*i);
+	return true;
+}
+
+/*
+ * Sets an integer from a field of digits, splitting the field by powers[level - 1] and
+ * parsing both halves in parallel (tasks gives the number of concurrent fields at this level)
+ */
+void par_int::set_str_split(mpz_ptr result, const char *digits, size_t width, int base,
+		const std::vector<__mpz_struct> &powers, size_t leaf, unsigned int level, unsigned int tasks) {
+	mpz_t high, low;
+	size_t split;
+	std::vector<std::function<void(void)> > parse;
+
+	// parse a leaf field whole
+	if(!level) {
+		mpz_set_str(result, std::string(digits, width).c_str(), base);
+		return;
+	}
+
+	// fields no wider than the split descend a level unsplit
+	split = leaf << (level - 1);
+	if(width <= split) {
+		set_str_split(result, digits, width, base, powers, leaf, level - 1, tasks);
+		return;
+	}
+
+	// parse high & low fields in parallel, then combine: result = high * base^split + low
+	mpz_init(high);
+	mpz_init(low);
+	parse.push_back(std::bind(set_str_split, high, digits, width - split, base, std::cref(powers), leaf, level - 1,
+			tasks * 2));
+	parse.push_back(std::bind(set_str_split, low, digits + (width - split), split, base, std::cref(powers), leaf,
+			level - 1, tasks * 2));
+	run(parse);
+	mul_split(result, high, &powers.at(level - 1), get_depth(tasks));
+	mpz_add(result, result, low);
+	mpz_clear(high);
+	mpz_clear(low);
+}
+
+/*
+ * Sets the number of worker threads
+ */
+bool par_int::set_threads(unsigned int threads) {
+
+	// at least one thread is required
+	if(!threads)
+		return false;
+	par_int::threads = threads;
+	return true;
+}
@@ -0,0 +1,127 @@
+/*
+ * Cli Calc -- a small CLI calculator
+ * Copyright (C) 2012 David Jolly
+ * ----------------------
+ * This file is part of Cli Calc
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PAR_INT_HPP_
+#define PAR_INT_HPP_
+
+#include <functional>
+#include <string>
+#include <vector>
+#include <gmp.h>
+
+class par_int {
+private:
+
+	/*
+	 * Number of worker threads
+	 */
+	static unsigned int threads;
+
+	/*
+	 * Converts a non-negative integer below base^width into a fixed-width field of digits (padded
+	 * with leading zeros), splitting by powers[level - 1] and converting both halves in parallel
+	 */
+	static void get_str_split(char *digits, size_t width, mpz_srcptr value, int base, const std::vector<__mpz_struct> &powers,
+			size_t leaf, unsigned int level);
+
+	/*
+	 * Returns the depth to which a multiply may split, given a number of concurrent tasks
+	 */
+	static unsigned int get_depth(unsigned int tasks);
+
+	/*
+	 * Multiplies two integers, splitting the operands across threads to a given depth
+	 * (karatsuba for balanced operands, halving the larger operand otherwise)
+	 */
+	static void mul_split(mpz_ptr result, mpz_srcptr first, mpz_srcptr second, unsigned int depth);
+
+	/*
+	 * Multiplies a range of word-sized factors as a product tree
+	 */
+	static void product(mpz_ptr result, const std::vector<unsigned long> &factors, size_t begin, size_t end);
+
+	/*
+	 * Multiplies a series of word-sized factors, spreading subtrees of the product tree across threads
+	 */
+	static void product_split(mpz_t result, const std::vector<unsigned long> &factors);
+
+	/*
+	 * Sets an integer from a field of digits, splitting the field by powers[level - 1] and
+	 * parsing both halves in parallel (tasks gives the number of concurrent fields at this level)
+	 */
+	static void set_str_split(mpz_ptr result, const char *digits, size_t width, int base,
+			const std::vector<__mpz_struct> &powers, size_t leaf, unsigned int level, unsigned int tasks);
+
+public:
+
+	/*
+	 * Minimum argument for a parallel factorial
+	 */
+	static const unsigned long FAC_THRESHOLD = 1 << 16;
+
+	/*
+	 * Minimum number of digits for a parallel radix conversion
+	 */
+	static const size_t STR_THRESHOLD = 1 << 17;
+
+	/*
+	 * Minimum operand size for a parallel multiply (in limbs)
+	 */
+	static const size_t MUL_THRESHOLD = 1 << 14;
+
+	/*
+	 * Computes a factorial, in parallel above the size threshold (as a product of prime powers)
+	 */
+	static void fac(mpz_t result, unsigned long value);
+
+	/*
+	 * Appends the digits of a non-negative integer in a given radix, in parallel above the size threshold
+	 */
+	static void get_str(std::string &str, const mpz_t value, int base);
+
+	/*
+	 * Returns the number of worker threads
+	 */
+	static unsigned int get_threads(void) { return threads; }
+
+	/*
+	 * Multiplies (or squares) two integers, in parallel above the size threshold
+	 */
+	static void mul(mpz_t result, const mpz_t first, const mpz_t second);
+
+	/*
+	 * Runs a series of tasks in parallel, the last on the calling thread (tasks
+	 * run sequentially if no threads can be started)
+	 */
+	static void run(std::vector<std::function<void(void)> > &tasks);
+
+	/*
+	 * Sets an integer from a string of digits in a given radix, in parallel above the size threshold
+	 * (returns false if a digit is invalid)
+	 */
+	static bool set_str(mpz_t result, const std::string &digits, int base);
+
+	/*
+	 * Sets the number of worker threads
+	 */
+	static bool set_threads(unsigned int threads);
+};
+
+#endif
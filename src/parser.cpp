@@ -97,6 +97,7 @@ void parser::cleanup(void) {
 		delete (*i);
 	}
 	tree.clear();
+	arena.reset();
 }
 
 /*
@@ -336,7 +337,7 @@ void parser::parse(void) {
 
 	// parse all statements and place them in the abstract syntax tree
 	while(lex.has_next()) {
-		syn_tree *curr = new syn_tree;
+		syn_tree *curr = new syn_tree(&arena);
 		if(!curr)
 			throw exc_code::MEM_FAILURE;
 		try {
@@ -25,12 +25,14 @@
 #include "exc_code.hpp"
 #include "lexer.hpp"
 #include "syn_tree.hpp"
+#include "tok_arena.hpp"
 #include "token.hpp"
 
 class parser {
 private:
 
 	lexer lex;
+	tok_arena arena;
 	std::vector<syn_tree *> tree;
 	std::string input;
 
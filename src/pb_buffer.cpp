@@ -18,7 +18,9 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include <sstream>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
 #include "exc_code.hpp"
 #include "pb_buffer.hpp"
 
@@ -27,7 +29,11 @@
  */
 pb_buffer::pb_buffer(void) {
 	ch = 0;
+	good = true;
 	pos = 0;
+	index = 0;
+	length = 0;
+	input = NULL;
 }
 
 /*
@@ -35,26 +41,35 @@ pb_buffer::pb_buffer(void) {
  */
 pb_buffer::pb_buffer(const pb_buffer &other) {
 	ch = 0;
+	good = true;
 	pos = 0;
-	input.assign(other.input);
-	stream.clear();
+	index = 0;
+	length = other.length;
+	input = other.input;
 }
 
 /*
- * Pushback Buffer constructor
+ * Pushback Buffer constructor (the input is referenced, not copied, and must outlive the buffer)
  */
 pb_buffer::pb_buffer(const std::string &input) {
 	ch = 0;
+	good = true;
 	pos = 0;
-	this->input.assign(input);
+	index = 0;
+	length = input.size();
+	this->input = input.data();
 }
 
 /*
- * Pushback Buffer destructor
+ * Pushback Buffer constructor (the input is referenced, not copied, and must outlive the buffer)
  */
-pb_buffer::~pb_buffer(void) {
-	input.clear();
-	stream.clear();
+pb_buffer::pb_buffer(const char *input, size_t length) {
+	ch = 0;
+	good = true;
+	pos = 0;
+	index = 0;
+	this->length = length;
+	this->input = input;
 }
 
 /*
@@ -68,9 +83,11 @@ pb_buffer &pb_buffer::operator=(const pb_buffer &other) {
 
 	// set attributes
 	ch = 0;
+	good = true;
 	pos = 0;
-	input.assign(other.input);
-	stream.clear();
+	index = 0;
+	length = other.length;
+	input = other.input;
 	return *this;
 }
 
@@ -85,8 +102,11 @@ bool pb_buffer::operator==(const pb_buffer &other) {
 
 	// check that all attributes are the same
 	return ch == other.ch
-			&& input == other.input
-			&& pos == other.pos;
+			&& pos == other.pos
+			&& length == other.length
+			&& (input == other.input
+			|| !length
+			|| !memcmp(input, other.input, length));
 }
 
 /*
@@ -121,10 +141,10 @@ bool pb_buffer::operator<<(char &ch) {
  * Initialize buffer
  */
 void pb_buffer::initialize(void) {
-	
-	// initialize stream
-	stream >> std::noskipws;
-	stream << input;
+
+	// initialize cursor
+	good = true;
+	index = 0;
 	pos = 0;
 	next();
 }
@@ -138,8 +158,11 @@ bool pb_buffer::next(void) {
 	if(!has_next())
 		return false;
 
-	// seek to the next character in stream
-	stream >> ch;
+	// read the next character, reading past the end leaves the last character current
+	if(index < length)
+		ch = input[index++];
+	else
+		good = false;
 	pos++;
 	return true;
 }
@@ -150,14 +173,51 @@ bool pb_buffer::next(void) {
 bool pb_buffer::previous(void) {
 
 	// check if stream has previous
-	if(!stream.tellg())
+	if(good
+			&& !index)
 		return false;
 
-	// seek two characters backwards
-	stream.seekg(-2, std::ios_base::cur);
-
-	// set ch to current character in stream
-	stream >> ch;
+	// step two characters backwards & re-read (a failed buffer only moves its position)
+	if(good
+			&& index > 1)
+		ch = input[(index -= 2)++];
+	else
+		good = false;
 	pos--;
 	return true;
 }
+
+/*
+ * Appends the run of decimal digits starting at the current character to text, advancing the
+ * buffer past them (returns the status of the buffer)
+ */
+bool pb_buffer::read_digits(std::string &text) {
+	uint64_t word;
+	size_t begin = index - 1, end = begin;
+
+	// check that the current character is a digit
+	if(!has_next()
+			|| !index
+			|| !isdigit(ch))
+		return has_next();
+
+	// scan eight characters at a time, every byte must be 0x30-0x39 (high nibble 3, low nibble + 6 < 16)
+	while(end + sizeof(word) <= length) {
+		memcpy(&word, input + end, sizeof(word));
+		if((word & 0xf0f0f0f0f0f0f0f0ULL) != 0x3030303030303030ULL
+				|| (((word & 0x0f0f0f0f0f0f0f0fULL) + 0x0606060606060606ULL) & 0xf0f0f0f0f0f0f0f0ULL))
+			break;
+		end += sizeof(word);
+	}
+	while(end < length
+			&& isdigit(input[end]))
+		end++;
+	text.append(input + begin, end - begin);
+
+	// move past the digits, leaving the last digit current at the end of input (as next does)
+	pos += end - index;
+	index = end;
+	ch = input[end - 1];
+	next();
+	return has_next();
+}
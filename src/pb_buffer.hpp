@@ -21,17 +21,17 @@
 #ifndef PB_BUFFER_HPP_
 #define PB_BUFFER_HPP_
 
-#include <fstream>
-#include <sstream>
+#include <cstddef>
 #include <string>
 
 class pb_buffer {
 private:
 
 	char ch;
+	bool good;
 	unsigned int pos;
-	std::string input;
-	std::stringstream stream;
+	size_t index, length;
+	const char *input;
 
 public:
 
@@ -46,14 +46,19 @@ public:
 	pb_buffer(const pb_buffer &other);
 
 	/*
-	 * Pushback Buffer constructor
+	 * Pushback Buffer constructor (the input is referenced, not copied, and must outlive the buffer)
 	 */
 	pb_buffer(const std::string &input);
 
+	/*
+	 * Pushback Buffer constructor (the input is referenced, not copied, and must outlive the buffer)
+	 */
+	pb_buffer(const char *input, size_t length);
+
 	/*
 	 * Pushback Buffer destructor
 	 */
-	virtual ~pb_buffer(void);
+	virtual ~pb_buffer(void) { return; }
 
 	/*
 	 * Pushback Buffer assignment
@@ -88,7 +93,12 @@ public:
 	/*
 	 * Returns the buffer's given input
 	 */
-	std::string &get_input(void) { return input; }
+	const char *get_input(void) { return input; }
+
+	/*
+	 * Returns the length of the buffer's given input
+	 */
+	size_t get_length(void) { return length; }
 
 	/*
 	 * Returns the buffer's current position in the stream
@@ -98,7 +108,7 @@ public:
 	/*
 	 * Returns the status of the buffer
 	 */
-	bool has_next(void) { return stream.good(); }
+	bool has_next(void) { return good; }
 
 	/*
 	 * Initialize buffer
@@ -115,10 +125,16 @@ public:
 	 */
 	bool previous(void);
 
+	/*
+	 * Appends the run of decimal digits starting at the current character to text, advancing the
+	 * buffer past them (returns the status of the buffer)
+	 */
+	bool read_digits(std::string &text);
+
 	/*
 	 * Resets the buffer to an initial state
 	 */
-	void reset(void) { stream.clear(); }
+	void reset(void) { good = true; }
 
 	/*
 	 * Returns a string representation of the current state of the buffer
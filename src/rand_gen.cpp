@@ -0,0 +1,71 @@
+/*
+ * Cli Calc -- a small CLI calculator
+ * Copyright (C) 2012 David Jolly
+ * ----------------------
+ * This file is part of Cli Calc
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <cstdint>
+#include "rand_gen.hpp"
+
+/*
+ * Sets a value to a normalized random number (0-1), in the current floating-point mode
+ */
+void rand_gen::next(num_value &value) {
+
+	// draw hardware floats from the current block
+	if(num_value::get_mode() == num_value::HARDWARE) {
+		if(position == block.size())
+			refill();
+		value.set_hardware(block[position++]);
+	} else
+		mpfr_urandomb(value.set_float(), state);
+}
+
+/*
+ * Refills the block of hardware floats
+ */
+void rand_gen::refill(void) {
+	mpz_t bits;
+	uint64_t words[BLOCK_SIZE] = { 0 };
+
+	// draw a 64-bit word per float in one call, keeping the high 53-bits of each
+	mpz_init(bits);
+	mpz_urandomb(bits, state, BLOCK_SIZE * 64);
+	mpz_export(words, NULL, -1, sizeof(uint64_t), 0, 0, bits);
+	for(size_t i = 0; i < block.size(); i++)
+		block[i] = ldexp((double) (words[i] >> 11), -53);
+	mpz_clear(bits);
+	position = 0;
+}
+
+/*
+ * Reseeds the generator (initializing it if needed)
+ */
+void rand_gen::set_seed(unsigned long seed) {
+
+	// initialize a mersenne twister on first use, then seed it
+	if(!initialized) {
+		gmp_randinit_mt(state);
+		initialized = true;
+	}
+	this->seed = seed;
+	gmp_randseed_ui(state, seed);
+
+	// discard floats drawn under the previous seed
+	position = block.size();
+}
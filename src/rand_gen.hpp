@@ -0,0 +1,85 @@
+/*
+ * Cli Calc -- a small CLI calculator
+ * Copyright (C) 2012 David Jolly
+ * ----------------------
+ * This file is part of Cli Calc
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RAND_GEN_HPP_
+#define RAND_GEN_HPP_
+
+#include <vector>
+#include <gmp.h>
+#include "num_value.hpp"
+
+class rand_gen {
+private:
+
+	gmp_randstate_t state;
+	bool initialized;
+	unsigned long seed;
+	std::vector<double> block;
+	size_t position;
+
+	/*
+	 * Random generator constructor (generators hold unique state)
+	 */
+	rand_gen(const rand_gen &other);
+
+	/*
+	 * Random generator assignment (generators hold unique state)
+	 */
+	rand_gen &operator=(const rand_gen &other);
+
+	/*
+	 * Refills the block of hardware floats
+	 */
+	void refill(void);
+
+public:
+
+	/*
+	 * Number of hardware floats drawn per block
+	 */
+	static const size_t BLOCK_SIZE = 256;
+
+	/*
+	 * Random generator constructor (the generator is initialized when first seeded)
+	 */
+	rand_gen(void) : initialized(false), seed(0), block(BLOCK_SIZE), position(BLOCK_SIZE) { return; }
+
+	/*
+	 * Random generator destructor
+	 */
+	virtual ~rand_gen(void) { if(initialized) gmp_randclear(state); }
+
+	/*
+	 * Returns the seed
+	 */
+	unsigned long get_seed(void) { return seed; }
+
+	/*
+	 * Sets a value to a normalized random number (0-1), in the current floating-point mode
+	 */
+	void next(num_value &value);
+
+	/*
+	 * Reseeds the generator (initializing it if needed)
+	 */
+	void set_seed(unsigned long seed);
+};
+
+#endif
@@ -0,0 +1,207 @@
+/*
+ * Cli Calc -- a small CLI calculator
+ * Copyright (C) 2012 David Jolly
+ * ----------------------
+ * This file is part of Cli Calc
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdlib>
+#include "reg_pool.hpp"
+
+/*
+ * Pooled registers
+ */
+__mpz_struct reg_pool::integers[reg_pool::MAX_SIZE];
+__mpfr_struct reg_pool::reals[reg_pool::MAX_SIZE];
+size_t reg_pool::integer_count = 0;
+size_t reg_pool::real_count = 0;
+
+/*
+ * Allocation statistics (memory functions are shared by worker threads)
+ */
+std::atomic<unsigned long long> reg_pool::allocations(0);
+std::atomic<unsigned long long> reg_pool::frees(0);
+std::atomic<long long> reg_pool::usage(0);
+std::atomic<long long> reg_pool::pooled(0);
+std::atomic<long long> reg_pool::peak(0);
+unsigned long long reg_pool::initialized = 0;
+unsigned long long reg_pool::reused = 0;
+
+/*
+ * Memory limit (in bytes, 0 for unlimited)
+ */
+size_t reg_pool::limit = 0;
+
+/*
+ * Precision of pooled float registers (0 until set)
+ */
+mpfr_prec_t reg_pool::precision = 0;
+
+/*
+ * Acquire a zeroed integer register
+ */
+void reg_pool::acquire(mpz_t value) {
+
+	// reuse the most recently released register, otherwise initialize a new one
+	if(integer_count) {
+		*value = integers[--integer_count];
+		mpz_set_ui(value, 0);
+		reused++;
+		pooled -= value->_mp_alloc * sizeof(mp_limb_t);
+		track(0);
+	} else {
+		mpz_init(value);
+		initialized++;
+	}
+}
+
+/*
+ * Acquire a float register of the given precision (value is NaN)
+ */
+void reg_pool::acquire(mpfr_t value, mpfr_prec_t precision) {
+
+	// reuse a register of matching precision, otherwise initialize a new one
+	if(real_count
+			&& mpfr_get_prec(&reals[real_count - 1]) == precision) {
+		*value = reals[--real_count];
+		mpfr_set_nan(value);
+		reused++;
+		pooled -= get_size(value);
+		track(0);
+	} else {
+		mpfr_init2(value, precision);
+		initialized++;
+	}
+}
+
+/*
+ * Counting memory allocation functions (handed to libgmp)
+ */
+void *reg_pool::allocate(size_t size) {
+	void *ptr = malloc(size);
+
+	// libgmp expects allocation to succeed
+	if(!ptr)
+		abort();
+	allocations++;
+	track(size);
+	return ptr;
+}
+
+/*
+ * Counting memory allocation functions (handed to libgmp)
+ */
+void *reg_pool::reallocate(void *ptr, size_t old_size, size_t new_size) {
+
+	// libgmp expects allocation to succeed
+	ptr = realloc(ptr, new_size);
+	if(!ptr)
+		abort();
+	allocations++;
+	track((long long) new_size - (long long) old_size);
+	return ptr;
+}
+
+/*
+ * Counting memory allocation functions (handed to libgmp)
+ */
+void reg_pool::deallocate(void *ptr, size_t size) {
+	free(ptr);
+	frees++;
+	track(-(long long) size);
+}
+
+/*
+ * Release all registers held by the pool
+ */
+void reg_pool::cleanup(void) {
+
+	// clear each pooled register
+	while(integer_count)
+		mpz_clear(&integers[--integer_count]);
+	while(real_count)
+		mpfr_clear(&reals[--real_count]);
+	pooled = 0;
+}
+
+/*
+ * Returns the number of bytes of limbs held by a float register
+ */
+long long reg_pool::get_size(mpfr_t value) {
+	return ((mpfr_get_prec(value) + GMP_NUMB_BITS - 1) / GMP_NUMB_BITS) * sizeof(mp_limb_t);
+}
+
+/*
+ * Adjusts the memory in use by a number of bytes, recording the peak held by values
+ */
+void reg_pool::track(long long bytes) {
+	long long current = (usage += bytes) - pooled, previous = peak;
+
+	// raise the peak, unless another thread raised it further
+	while(current > previous
+			&& !peak.compare_exchange_weak(previous, current));
+}
+
+/*
+ * Install the counting memory allocation functions
+ */
+void reg_pool::initialize(void) {
+	mp_set_memory_functions(allocate, reallocate, deallocate);
+}
+
+/*
+ * Return an integer register to the pool (limbs are kept)
+ */
+void reg_pool::release(mpz_t value) {
+
+	// clear the register if the pool is full, or if it holds a large value
+	if(integer_count == MAX_SIZE
+			|| value->_mp_alloc > MAX_LIMBS)
+		mpz_clear(value);
+	else {
+		integers[integer_count++] = *value;
+		pooled += value->_mp_alloc * sizeof(mp_limb_t);
+	}
+}
+
+/*
+ * Return a float register to the pool (limbs are kept, registers not at the pool's precision are cleared)
+ */
+void reg_pool::release(mpfr_t value) {
+
+	// clear the register if the pool is full, or if it holds another precision
+	if(real_count == MAX_SIZE
+			|| mpfr_get_prec(value) != precision)
+		mpfr_clear(value);
+	else {
+		reals[real_count++] = *value;
+		pooled += get_size(value);
+	}
+}
+
+/*
+ * Sets the precision of pooled float registers, releasing registers of any other precision
+ */
+void reg_pool::set_precision(mpfr_prec_t precision) {
+
+	// the pool follows the working precision
+	if(precision != reg_pool::precision)
+		while(real_count) {
+			pooled -= get_size(&reals[--real_count]);
+			mpfr_clear(&reals[real_count]);
+		}
+	reg_pool::precision = precision;
+}
@@ -0,0 +1,167 @@
+/*
+ * Cli Calc -- a small CLI calculator
+ * Copyright (C) 2012 David Jolly
+ * ----------------------
+ * This file is part of Cli Calc
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REG_POOL_HPP_
+#define REG_POOL_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <gmp.h>
+#include <mpfr.h>
+
+class reg_pool {
+private:
+
+	static __mpz_struct integers[];
+	static __mpfr_struct reals[];
+	static size_t integer_count, real_count;
+	static std::atomic<unsigned long long> allocations, frees;
+	static std::atomic<long long> usage, pooled, peak;
+	static unsigned long long initialized, reused;
+	static size_t limit;
+	static mpfr_prec_t precision;
+
+	/*
+	 * Counting memory allocation functions (handed to libgmp)
+	 */
+	static void *allocate(size_t size);
+	static void *reallocate(void *ptr, size_t old_size, size_t new_size);
+	static void deallocate(void *ptr, size_t size);
+
+	/*
+	 * Returns the number of bytes of limbs held by a float register
+	 */
+	static long long get_size(mpfr_t value);
+
+	/*
+	 * Adjusts the memory in use by a number of bytes, recording the peak held by values
+	 */
+	static void track(long long bytes);
+
+public:
+
+	/*
+	 * Maximum number of registers held of each type
+	 */
+	static const size_t MAX_SIZE = 128;
+
+	/*
+	 * Maximum number of limbs held by a pooled integer register (larger registers are cleared)
+	 */
+	static const int MAX_LIMBS = 1 << 12;
+
+	/*
+	 * Acquire a zeroed integer register
+	 */
+	static void acquire(mpz_t value);
+
+	/*
+	 * Acquire a float register of the given precision (value is NaN)
+	 */
+	static void acquire(mpfr_t value, mpfr_prec_t precision);
+
+	/*
+	 * Release all registers held by the pool
+	 */
+	static void cleanup(void);
+
+	/*
+	 * Returns true if a further number of bytes fits under the memory limit (pooled registers are not counted)
+	 */
+	static bool fits(double bytes) { return !limit || usage - pooled + bytes <= limit; }
+
+	/*
+	 * Returns the number of libgmp/libmpfr memory allocations (including reallocations)
+	 */
+	static unsigned long long get_allocations(void) { return allocations; }
+
+	/*
+	 * Returns the number of libgmp/libmpfr memory releases
+	 */
+	static unsigned long long get_frees(void) { return frees; }
+
+	/*
+	 * Returns the memory limit (in bytes, 0 for unlimited)
+	 */
+	static size_t get_limit(void) { return limit; }
+
+	/*
+	 * Returns the peak libgmp/libmpfr memory held by values since the last reset (in bytes, pooled registers
+	 * are not counted)
+	 */
+	static long long get_peak(void) { return peak; }
+
+	/*
+	 * Returns the libgmp/libmpfr memory in use (in bytes)
+	 */
+	static long long get_usage(void) { return usage; }
+
+	/*
+	 * Returns the libgmp/libmpfr memory held by pooled registers (in bytes)
+	 */
+	static long long get_pooled(void) { return pooled; }
+
+	/*
+	 * Returns the number of registers initialized
+	 */
+	static unsigned long long get_initialized(void) { return initialized; }
+
+	/*
+	 * Returns the number of registers reused from the pool
+	 */
+	static unsigned long long get_reused(void) { return reused; }
+
+	/*
+	 * Install the counting memory allocation functions
+	 */
+	static void initialize(void);
+
+	/*
+	 * Returns true if the peak memory held by values since the last reset passed the memory limit
+	 */
+	static bool is_exceeded(void) { return limit && peak > (long long) limit; }
+
+	/*
+	 * Return an integer register to the pool (limbs are kept)
+	 */
+	static void release(mpz_t value);
+
+	/*
+	 * Return a float register to the pool (limbs are kept, registers not at the pool's precision are cleared)
+	 */
+	static void release(mpfr_t value);
+
+	/*
+	 * Resets the peak memory held by values to the current usage (less pooled registers)
+	 */
+	static void reset_peak(void) { peak = usage - pooled; }
+
+	/*
+	 * Sets the precision of pooled float registers, releasing registers of any other precision
+	 */
+	static void set_precision(mpfr_prec_t precision);
+
+	/*
+	 * Sets the memory limit (in bytes, 0 for unlimited)
+	 */
+	static void set_limit(size_t limit) { reg_pool::limit = limit; }
+};
+
+#endif
@@ -0,0 +1,308 @@
+/*
+ * Cli Calc -- a small CLI calculator
+ * Copyright (C) 2012 David Jolly
+ * ----------------------
+ * This file is part of Cli Calc
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "lexer.hpp"
+#include "sub_table.hpp"
+
+/*
+ * Marks no subexpression
+ */
+const unsigned int sub_table::NONE;
+
+/*
+ * Adds the subexpressions of a program evaluated after those already added (programs must outlive the table)
+ */
+void sub_table::add(byte_code &code) {
+	key k;
+	size_t hash;
+	unsigned int id, start, first, second;
+	size_t base = ids.size();
+	std::vector<byte_code::instruction> &program = code.get_program();
+
+	// programs that fail are left as is
+	if(is_failure(code))
+		return;
+
+	// key each instruction over the subexpressions it consumes, noting where each subexpression starts
+	operands.clear();
+	for(unsigned int i = 0; i < program.size(); i++) {
+		byte_code::instruction &instr = program[i];
+		k.op = instr.op;
+		k.type = instr.type;
+		k.code = instr.code;
+		k.first = NONE;
+		k.second = NONE;
+		start = i;
+		switch(instr.op) {
+
+			// literals are equal by value
+			case byte_code::LITERAL:
+				hash = code.get_literal(instr.code).get_hash();
+				k.code = (unsigned int) hash;
+				k.first = (unsigned int) (hash >> 32);
+				id = find(k, &code.get_literal(instr.code), true);
+				break;
+
+			// loads are equal until their identifier is redefined
+			case byte_code::LOAD:
+				k.first = versions[instr.code];
+				id = find(k, NULL, true);
+				break;
+
+			// random numbers are never equal
+			case byte_code::CONSTANT: id = find(k, NULL, instr.code != lexer::RAND);
+				break;
+
+			// operations by a power of 2 are keyed by its exponent (the literal belongs to the program)
+			case byte_code::SHIFT:
+				k.code = __builtin_ctzll(code.get_literal(instr.code).get_small());
+				// fall through
+
+			// functions, negations, casts & checks of a single operand
+			case byte_code::CALL:
+			case byte_code::CHECK:
+			case byte_code::NEGATE:
+			case byte_code::ROUND:
+				first = operands.back();
+				operands.pop_back();
+				k.first = ids[base + first];
+				start = starts[base + first];
+				id = find(k, NULL, true);
+				break;
+
+			// operators of two operands
+			case byte_code::OPER:
+				second = operands.back();
+				operands.pop_back();
+				first = operands.back();
+				operands.pop_back();
+				k.first = ids[base + first];
+				k.second = ids[base + second];
+				start = starts[base + first];
+				id = find(k, NULL, true);
+				break;
+			default: id = find(k, NULL, false);
+				break;
+		}
+		ids.push_back(id);
+		starts.push_back(start);
+		operands.push_back(i);
+	}
+
+	// the program's value is a use of its root
+	if(!operands.empty())
+		nodes[ids[base + operands.back()]].count++;
+}
+
+/*
+ * Marks an identifier as redefined, loads added after it are distinct subexpressions
+ */
+void sub_table::assign(unsigned int id) {
+	versions[id]++;
+}
+
+/*
+ * Release all subexpressions
+ */
+void sub_table::cleanup(void) {
+	indexed = 0;
+	position = 0;
+	slots = 0;
+	nodes.clear();
+	index.clear();
+	versions.clear();
+	ids.clear();
+	starts.clear();
+	spare.clear();
+}
+
+/*
+ * Returns the subexpression for a key (& literal value), adding it (& counting its operands) if it is new
+ */
+unsigned int sub_table::find(const key &k, num_value *literal, bool pure) {
+	node nd;
+	size_t pos = 0;
+	std::vector<unsigned int> grown;
+
+	// return an equal subexpression (if one exists)
+	if(pure) {
+		pos = find_slot(k, literal);
+		if(index[pos] != NONE)
+			return index[pos];
+	}
+
+	// add a subexpression, it is worth sharing if it evaluates a function or operator
+	nd.k = k;
+	nd.count = 0;
+	nd.slot = NONE;
+	nd.uses = 0;
+	nd.heavy = (k.op == byte_code::CALL
+			|| k.op == byte_code::OPER
+			|| k.op == byte_code::ROUND
+			|| k.op == byte_code::SHIFT);
+	nd.indexed = pure;
+	nd.literal = literal;
+	if(k.op == byte_code::CALL
+			|| k.op == byte_code::CHECK
+			|| k.op == byte_code::NEGATE
+			|| k.op == byte_code::OPER
+			|| k.op == byte_code::ROUND
+			|| k.op == byte_code::SHIFT) {
+		nodes[k.first].count++;
+		nd.heavy |= nodes[k.first].heavy;
+	}
+	if(k.op == byte_code::OPER) {
+		nodes[k.second].count++;
+		nd.heavy |= nodes[k.second].heavy;
+	}
+	nodes.push_back(nd);
+	if(!pure)
+		return nodes.size() - 1;
+	index[pos] = nodes.size() - 1;
+
+	// double the index once it is half full
+	if(++indexed * 2 > index.size()) {
+		grown.assign(index.size() * 2, NONE);
+		index.swap(grown);
+		for(unsigned int i = 0; i < nodes.size(); i++)
+			if(nodes[i].indexed)
+				index[find_slot(nodes[i].k, nodes[i].literal)] = i;
+	}
+	return nodes.size() - 1;
+}
+
+/*
+ * Returns the index slot of a subexpression key (& literal value), either holding an equal subexpression or
+ * empty
+ */
+size_t sub_table::find_slot(const key &k, num_value *literal) {
+	size_t mask, pos;
+
+	// allocate the index on first use
+	if(index.empty())
+		index.assign(INDEX_SIZE, NONE);
+
+	// probe from the key's hash until an equal or empty slot
+	mask = index.size() - 1;
+	for(pos = hash_key(k) & mask; index[pos] != NONE; pos = (pos + 1) & mask) {
+		node &nd = nodes[index[pos]];
+		if(nd.k.op == k.op
+				&& nd.k.type == k.type
+				&& nd.k.code == k.code
+				&& nd.k.first == k.first
+				&& nd.k.second == k.second
+				&& (!literal || *nd.literal == *literal))
+			return pos;
+	}
+	return pos;
+}
+
+/*
+ * Returns the hash of a subexpression key
+ */
+size_t sub_table::hash_key(const key &k) {
+	size_t hash = k.op;
+
+	// combine each attribute in turn
+	hash = (hash * 31) + k.type;
+	hash = (hash * 0x9e3779b97f4a7c15ULL) + k.code;
+	hash = (hash * 0x9e3779b97f4a7c15ULL) + k.first;
+	hash = (hash * 0x9e3779b97f4a7c15ULL) + k.second;
+	return hash ^ (hash >> 29);
+}
+
+/*
+ * Returns true if a program evaluates to a failure (and is left as is)
+ */
+bool sub_table::is_failure(byte_code &code) {
+	std::vector<byte_code::instruction> &program = code.get_program();
+
+	// search for a failure
+	for(std::vector<byte_code::instruction>::iterator i = program.begin(); i != program.end(); ++i)
+		if(i->op == byte_code::FAIL)
+			return true;
+	return false;
+}
+
+/*
+ * Rewrites a program (in the order added) so subexpressions evaluated more than once are stored on their
+ * first evaluation & fetched after it
+ */
+void sub_table::share(byte_code &code) {
+	unsigned int pos, sub;
+	byte_code::instruction instr;
+	size_t base = position;
+	std::vector<byte_code::instruction> &program = code.get_program();
+
+	// programs that fail are left as is
+	if(is_failure(code))
+		return;
+	position += program.size();
+
+	// chain the subexpressions starting at each instruction, outermost first
+	head.assign(program.size(), NONE);
+	inner.resize(program.size());
+	for(unsigned int i = 0; i < program.size(); i++) {
+		inner[i] = head[starts[base + i]];
+		head[starts[base + i]] = i;
+	}
+
+	// copy instructions, fetching subexpressions that are already stored
+	shared.clear();
+	for(pos = 0; pos < program.size(); pos++) {
+		for(sub = head[pos]; sub != NONE; sub = inner[sub])
+			if(nodes[ids[base + sub]].slot != NONE)
+				break;
+
+		// fetch a stored value (taking it on its last use, so its slot can be reused)
+		if(sub != NONE) {
+			node &nd = nodes[ids[base + sub]];
+			instr.op = --nd.uses ? byte_code::FETCH : byte_code::TAKE;
+			instr.type = 0;
+			instr.code = nd.slot;
+			shared.push_back(instr);
+			if(!nd.uses) {
+				spare.push_back(nd.slot);
+				nd.slot = NONE;
+			}
+			pos = sub;
+			continue;
+		}
+
+		// evaluate the instruction, storing its value if it is used again
+		shared.push_back(program[pos]);
+		node &nd = nodes[ids[base + pos]];
+		if(nd.heavy
+				&& nd.count > 1) {
+			if(spare.empty())
+				nd.slot = slots++;
+			else {
+				nd.slot = spare.back();
+				spare.pop_back();
+			}
+			nd.uses = nd.count - 1;
+			instr.op = byte_code::STORE;
+			instr.type = 0;
+			instr.code = nd.slot;
+			shared.push_back(instr);
+		}
+	}
+	program.swap(shared);
+}
@@ -0,0 +1,146 @@
+/*
+ * Cli Calc -- a small CLI calculator
+ * Copyright (C) 2012 David Jolly
+ * ----------------------
+ * This file is part of Cli Calc
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SUB_TABLE_HPP_
+#define SUB_TABLE_HPP_
+
+#include <cstddef>
+#include <map>
+#include <vector>
+#include "byte_code.hpp"
+#include "num_value.hpp"
+
+class sub_table {
+private:
+
+	/*
+	 * Subexpression key, an instruction over the subexpressions it consumes (literals are keyed by the hash
+	 * of their value, loads by their identifier & its version)
+	 */
+	struct key {
+		unsigned int op;
+		unsigned int type;
+		unsigned int code;
+		unsigned int first;
+		unsigned int second;
+	};
+
+	/*
+	 * Subexpression (counting its uses & the slot holding its value once stored)
+	 */
+	struct node {
+		key k;
+		unsigned int count;
+		unsigned int slot;
+		unsigned int uses;
+		bool heavy;
+		bool indexed;
+		num_value *literal;
+	};
+
+	size_t indexed, position;
+	unsigned int slots;
+	std::vector<node> nodes;
+	std::vector<unsigned int> index;
+	std::map<unsigned int, unsigned int> versions;
+	std::vector<unsigned int> ids, starts, operands, head, inner, spare;
+	std::vector<byte_code::instruction> shared;
+
+	/*
+	 * Sub table constructor (tables hold pointers into their programs)
+	 */
+	sub_table(const sub_table &other);
+
+	/*
+	 * Sub table assignment (tables hold pointers into their programs)
+	 */
+	sub_table &operator=(const sub_table &other);
+
+	/*
+	 * Returns the subexpression for a key (& literal value), adding it (& counting its operands) if it is new
+	 */
+	unsigned int find(const key &k, num_value *literal, bool pure);
+
+	/*
+	 * Returns the index slot of a subexpression key (& literal value), either holding an equal subexpression or
+	 * empty
+	 */
+	size_t find_slot(const key &k, num_value *literal);
+
+	/*
+	 * Returns the hash of a subexpression key
+	 */
+	static size_t hash_key(const key &k);
+
+	/*
+	 * Returns true if a program evaluates to a failure (and is left as is)
+	 */
+	static bool is_failure(byte_code &code);
+
+public:
+
+	/*
+	 * Marks no subexpression
+	 */
+	static const unsigned int NONE = (unsigned int) -1;
+
+	/*
+	 * Initial number of index slots (a power of 2, the index doubles when half full)
+	 */
+	static const size_t INDEX_SIZE = 1 << 10;
+
+	/*
+	 * Sub table constructor
+	 */
+	sub_table(void) : indexed(0), position(0), slots(0) { return; }
+
+	/*
+	 * Sub table destructor
+	 */
+	virtual ~sub_table(void) { cleanup(); }
+
+	/*
+	 * Adds the subexpressions of a program evaluated after those already added (programs must outlive the table)
+	 */
+	void add(byte_code &code);
+
+	/*
+	 * Marks an identifier as redefined, loads added after it are distinct subexpressions
+	 */
+	void assign(unsigned int id);
+
+	/*
+	 * Release all subexpressions
+	 */
+	void cleanup(void);
+
+	/*
+	 * Returns the number of slots needed to hold shared values
+	 */
+	unsigned int get_slots(void) { return slots; }
+
+	/*
+	 * Rewrites a program (in the order added) so subexpressions evaluated more than once are stored on their
+	 * first evaluation & fetched after it
+	 */
+	void share(byte_code &code);
+};
+
+#endif
@@ -23,6 +23,11 @@
 #include "exc_code.hpp"
 #include "sym_table.hpp"
 
+/*
+ * Interned identifiers (id 0 is reserved)
+ */
+std::map<std::string, unsigned int> sym_table::ids;
+
 /*
  * Symbol table assignment
  */
@@ -34,6 +39,7 @@ sym_table &sym_table::operator=(const sym_table &other) {
 
 	cleanup();
 	table = other.table;
+	index = other.index;
 	return *this;
 }
 
@@ -59,6 +65,18 @@ bool sym_table::operator==(const sym_table &other) {
 	return true;
 }
 
+/*
+ * Rebuilds the index of table entries by interned identifier
+ */
+void sym_table::build_index(void) {
+	std::map<std::string, token *>::iterator i = table.begin();
+
+	// index each entry under its name's identifier
+	index.clear();
+	for(; i != table.end(); ++i)
+		index_key(i->first);
+}
+
 /*
  * Cleanup resources used by symbol table
  */
@@ -69,6 +87,7 @@ void sym_table::cleanup(void) {
 	for(; i != table.end(); ++i)
 		delete i->second;
 	table.clear();
+	index.clear();
 }
 
 /*
@@ -107,33 +126,74 @@ bool sym_table::get_type(const std::string &key, unsigned int &type) {
  * Returns the values of the token in the table (if it exists)
  */
 bool sym_table::get_value(const std::string &key, token &value) {
-	token tok;
+	std::map<std::string, token *>::iterator entry = table.find(key);
 
 	// check if key exists
-	if(!contains(key))
+	if(entry == table.end())
 		return false;
 
 	// set value
-	tok = *table[key];
-	value.set_text(tok.get_text());
-	value.set_type(tok.get_type());
+	value.set_text(entry->second->get_text());
+	value.set_type(entry->second->get_type());
+	value.get_value() = entry->second->get_value();
 	return true;
 }
 
+/*
+ * Returns the value of the token in the table by interned identifier (if it exists)
+ */
+bool sym_table::get_value(unsigned int id, num_value &value) {
+
+	// check if identifier is set
+	if(id >= index.size()
+			|| !index.at(id))
+		return false;
+
+	// set value
+	value = index.at(id)->get_value();
+	return true;
+}
+
+/*
+ * Indexes a table entry by its interned identifier
+ */
+void sym_table::index_key(const std::string &key) {
+	unsigned int id = intern(key);
+
+	// grow the index to hold the identifier
+	if(index.size() <= id)
+		index.resize(id + 1);
+	index.at(id) = table[key];
+}
+
+/*
+ * Returns the identifier interned for a name, interning it if necessary
+ */
+unsigned int sym_table::intern(const std::string &name) {
+	std::map<std::string, unsigned int>::iterator entry = ids.find(name);
+
+	// assign the next identifier to new names
+	if(entry == ids.end())
+		entry = ids.insert(std::make_pair(name, ids.size() + 1)).first;
+	return entry->second;
+}
+
 /*
  * Sets value to the values of the token in the table (if it exists)
  */
 bool sym_table::set_value(const std::string &key, token &value) {
 
 	// check if key exists
-	if(!contains(key))
+	if(!contains(key)) {
 		table[key] = new token(value.get_text(), value.get_type(), NULL);
 		if(!table[key])
 			throw exc_code::MEM_FAILURE;
-	else {
+		index_key(key);
+	} else {
 		table[key]->set_text(value.get_text());
 		table[key]->set_type(value.get_type());
 	}
+	table[key]->get_value() = value.get_value();
 	return true;
 }
 
@@ -147,6 +207,7 @@ bool sym_table::set_value(const std::string &key, const std::string &text, unsig
 		table[key] = new token(text, type, NULL);
 		if(!table[key])
 			throw exc_code::MEM_FAILURE;
+		index_key(key);
 	} else {
 		table[key]->set_text(text);
 		table[key]->set_type(type);
@@ -158,6 +219,7 @@ bool sym_table::set_value(const std::string &key, const std::string &text, unsig
  * Returns a string representation of the current state of the symbol table
  */
 void sym_table::to_string(std::string &str) {
+	std::string text;
 	std::stringstream ss;
 	std::map<std::string, token *>::iterator i = table.begin();
 
@@ -165,7 +227,8 @@ void sym_table::to_string(std::string &str) {
 	if(!empty())
 		for(; i != table.end(); ++i) {
 			ss.str("");
-			ss << i->first << " --> " << i->second->get_text() << std::endl;
+			i->second->get_value().to_string(text);
+			ss << i->first << " --> " << text << std::endl;
 			str.append(ss.str());
 		}
 }
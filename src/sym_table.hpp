@@ -23,29 +23,46 @@
 
 #include <map>
 #include <string>
+#include <vector>
 #include "token.hpp"
 
 class sym_table {
 private:
 
 	std::map<std::string, token *> table;
+	std::vector<token *> index;
+
+	/*
+	 * Interned identifiers (id 0 is reserved)
+	 */
+	static std::map<std::string, unsigned int> ids;
+
+	/*
+	 * Rebuilds the index of table entries by interned identifier
+	 */
+	void build_index(void);
+
+	/*
+	 * Indexes a table entry by its interned identifier
+	 */
+	void index_key(const std::string &key);
 
 public:
 
 	/*
 	 * Symbol table constructor
 	 */
-	sym_table(void) { table.clear(); }
+	sym_table(void) { table.clear(); index.clear(); }
 
 	/*
 	 * Symbol table constructor
 	 */
-	sym_table(const sym_table &other) { table = other.table; }
+	sym_table(const sym_table &other) { table = other.table; index = other.index; }
 
 	/*
 	 * Symbol table constructor
 	 */
-	sym_table(std::map<std::string, token *> &table) { this->table = table; }
+	sym_table(std::map<std::string, token *> &table) { this->table = table; build_index(); }
 
 	/*
 	 * Symbol table destructor
@@ -72,6 +89,11 @@ public:
 	 */
 	void cleanup(void);
 
+	/*
+	 * Forget all interned identifiers (no table may hold entries indexed by them)
+	 */
+	static void clear_ids(void) { ids.clear(); }
+
 	/*
 	 * Test if key exists within table
 	 */
@@ -97,6 +119,16 @@ public:
 	 */
 	bool get_value(const std::string &key, token &value);
 
+	/*
+	 * Returns the value of the token in the table by interned identifier (if it exists)
+	 */
+	bool get_value(unsigned int id, num_value &value);
+
+	/*
+	 * Returns the identifier interned for a name, interning it if necessary
+	 */
+	static unsigned int intern(const std::string &name);
+
 	/*
 	 * Sets the text value to the values of the token in the table (if it exists)
 	 */
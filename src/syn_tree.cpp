@@ -31,6 +31,7 @@ syn_tree::syn_tree(void) {
 	// assign new attributes
 	root = NULL;
 	cur = NULL;
+	arena = NULL;
 }
 
 /*
@@ -41,9 +42,21 @@ syn_tree::syn_tree(const syn_tree &other) {
 	// assign new attributes
 	root = other.root;
 	cur = other.cur;
+	arena = other.arena;
 	cache = other.cache;
 }
 
+/*
+ * Syntax tree constructor (tokens are allocated from the given arena)
+ */
+syn_tree::syn_tree(tok_arena *arena) {
+
+	// assign new attributes
+	root = NULL;
+	cur = NULL;
+	this->arena = arena;
+}
+
 /*
  * Syntax tree constructor
  */
@@ -52,6 +65,7 @@ syn_tree::syn_tree(token *root) {
 	// assign new attributes
 	this->root = root;
 	this->cur = root;
+	arena = NULL;
 }
 
 /*
@@ -62,6 +76,7 @@ syn_tree::syn_tree(token *root, token *cur) {
 	// assign new attributes
 	this->root = root;
 	this->cur = cur;
+	arena = NULL;
 }
 
 /*
@@ -79,6 +94,7 @@ syn_tree &syn_tree::operator=(const syn_tree &other) {
 	// assign new attributes
 	root = other.root;
 	cur = other.cur;
+	arena = other.arena;
 	cache = other.cache;
 	return *this;
 }
@@ -96,13 +112,31 @@ bool syn_tree::operator==(const syn_tree &other) {
 	return tree_equals(root, other.root);
 }
 
+/*
+ * Add a child token to the current token
+ */
+bool syn_tree::add_child(token &tok) {
+
+	// add the child & carry over its code & value
+	if(!add_child(tok.get_text(), tok.get_type()))
+		return false;
+	if(cur->size()) {
+		cur->get_child(cur->size() - 1)->set_code(tok.get_code());
+		cur->get_child(cur->size() - 1)->get_value() = tok.get_value();
+	} else {
+		cur->set_code(tok.get_code());
+		cur->get_value() = tok.get_value();
+	}
+	return true;
+}
+
 /*
  * Add a child token to the current token
  */
 bool syn_tree::add_child(const std::string &text, unsigned int type) {
 
 	// make sure allocation does not fail
-	token *child = new token(text, type, cur);
+	token *child = arena ? arena->allocate(text, type, cur) : new token(text, type, cur);
 	if(!child)
 		return false;
 
@@ -194,8 +228,9 @@ bool syn_tree::cleanup_helper(token **root) {
 	// remove child tokens
 	(*root)->remove_children();
 
-	// remove root token
-	delete (*root);
+	// remove root token (arena tokens are released with their arena)
+	if(!arena)
+		delete (*root);
 	(*root) = NULL;
 	return true;
 }
@@ -249,6 +284,8 @@ bool syn_tree::get_contents(token &tok) {
 	// set the text & type
 	tok.set_text(cur->get_text());
 	tok.set_type(cur->get_type());
+	tok.set_code(cur->get_code());
+	tok.get_value() = cur->get_value();
 	return true;
 }
 
@@ -267,6 +304,8 @@ bool syn_tree::get_child_contents(token &tok, unsigned int index) {
 	token *child = cur->get_child(index);
 	tok.set_text(child->get_text());
 	tok.set_type(child->get_type());
+	tok.set_code(child->get_code());
+	tok.get_value() = child->get_value();
 	return true;
 }
 
@@ -318,6 +357,20 @@ bool syn_tree::get_text(std::string &text) {
 	return true;
 }
 
+/*
+ * Returns the code of the current token (keyword index or interned identifier)
+ */
+bool syn_tree::get_code(unsigned int &code) {
+
+	// check that root token exists
+	if(!root)
+		return false;
+
+	// retrieve code
+	code = cur->get_code();
+	return true;
+}
+
 /*
  * Returns the type of the current token
  */
@@ -344,6 +397,8 @@ bool syn_tree::get_root_contents(token &tok) {
 	// set the text & type
 	tok.set_text(root->get_text());
 	tok.set_type(root->get_type());
+	tok.set_code(root->get_code());
+	tok.get_value() = root->get_value();
 	return true;
 }
 
@@ -396,7 +451,6 @@ bool syn_tree::pop_cache(void) {
 void syn_tree::print_tree_helper(token *root, std::string &str) {
 	std::string tok_str;
 	std::queue<token *> que;
-	std::vector<token *>::iterator i;
 
 	// check that root token exists
 	if(!root)
@@ -411,9 +465,8 @@ void syn_tree::print_tree_helper(token *root, std::string &str) {
 		tok->to_string(tok_str);
 		str.append(tok_str);
 		str.append("\n");
-		i = tok->get_children().begin();
-		for(; i != tok->get_children().end(); ++i)
-			que.push(*i);
+		for(token *child = tok->get_first(); child; child = child->get_next())
+			que.push(child);
 	}
 }
 
@@ -500,6 +553,8 @@ bool syn_tree::set_contents(token &tok) {
 	// set current token contents
 	cur->set_text(tok.get_text());
 	cur->set_type(tok.get_type());
+	cur->set_code(tok.get_code());
+	cur->get_value() = tok.get_value();
 	return true;
 }
 
@@ -518,6 +573,8 @@ bool syn_tree::set_child_contents(token &tok, unsigned int index) {
 	token *child = cur->get_child(index);
 	child->set_text(tok.get_text());
 	child->set_type(tok.get_type());
+	child->set_code(tok.get_code());
+	child->get_value() = tok.get_value();
 	return true;
 }
 
@@ -583,6 +640,20 @@ bool syn_tree::set_type(unsigned int type) {
 	return true;
 }
 
+/*
+ * Exchange the value of the current token with the given value
+ */
+bool syn_tree::swap_value(num_value &value) {
+
+	// make sure current token exists
+	if(!cur)
+		return false;
+
+	// exchange values (the token is retyped to match)
+	cur->swap_value(value);
+	return true;
+}
+
 /*
  * Returns a string representation of the current state of the tree
  */
@@ -23,29 +23,27 @@
 
 #include <stack>
 #include <string>
+#include <vector>
+#include "tok_arena.hpp"
 #include "token.hpp"
 
 class syn_tree {
 private:
 
 	token *root, *cur;
-	std::stack<token *> cache;
+	tok_arena *arena;
+	std::stack<token *, std::vector<token *> > cache;
 
 	/*
-	 * Release resources used by tree
+	 * Release resources used by tree (tokens held by an arena are only unlinked)
 	 */
-	static bool cleanup_helper(token **root);
+	bool cleanup_helper(token **root);
 
 	/*
 	 * Copy a tree from a given root token
 	 */
 	static bool copy_helper(syn_tree &copy, token *root, int advance);
 
-	/*
-	 * Returns the current pointer
-	 */
-	token *get_current(void) { return cur; }
-
 	/*
 	 * Returns the root pointer
 	 */
@@ -83,6 +81,11 @@ public:
 	 */
 	syn_tree(const syn_tree &other);
 
+	/*
+	 * Syntax tree constructor (tokens are allocated from the given arena)
+	 */
+	syn_tree(tok_arena *arena);
+
 	/*
 	 * Syntax tree constructor
 	 */
@@ -116,7 +119,7 @@ public:
 	/*
 	 * Add a child token to the current token
 	 */
-	bool add_child(token &tok) { return add_child(tok.get_text(), tok.get_type()); }
+	bool add_child(token &tok);
 
 	/*
 	 * Add a child token to the current token
@@ -178,6 +181,16 @@ public:
 	 */
 	bool get_text(std::string &text);
 
+	/*
+	 * Returns the current token
+	 */
+	token *get_current(void) { return cur; }
+
+	/*
+	 * Returns the code of the current token (keyword index or interned identifier)
+	 */
+	bool get_code(unsigned int &code);
+
 	/*
 	 * Returns the type of the current token
 	 */
@@ -263,6 +276,11 @@ public:
 	 */
 	bool set_type(unsigned int type);
 
+	/*
+	 * Exchange the value of the current token with the given value
+	 */
+	bool swap_value(num_value &value);
+
 	/*
 	 * Returns a string representation of the current state of the token
 	 */
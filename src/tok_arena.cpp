@@ -0,0 +1,75 @@
+/*
+ * Cli Calc -- a small CLI calculator
+ * Copyright (C) 2012 David Jolly
+ * ----------------------
+ * This file is part of Cli Calc
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tok_arena.hpp"
+
+/*
+ * Token arena assignment (arenas are not shared, tokens in use are reset)
+ */
+tok_arena &tok_arena::operator=(const tok_arena &other) {
+
+	// check for self-assignment
+	if(this == &other)
+		return *this;
+	reset();
+	return *this;
+}
+
+/*
+ * Returns a token from the arena, set to the given text, type & parent
+ */
+token *tok_arena::allocate(const std::string &text, unsigned int type, token *parent) {
+	token *tok;
+
+	// add a block once all blocks are in use
+	if(used == blocks.size() * BLOCK_SIZE)
+		blocks.push_back(new token[BLOCK_SIZE]);
+	tok = &blocks.at(used / BLOCK_SIZE)[used % BLOCK_SIZE];
+	used++;
+
+	// set attributes (tokens are reset when the arena is)
+	tok->set_text(text);
+	tok->set_type(type);
+	tok->set_parent(parent);
+	return tok;
+}
+
+/*
+ * Release all blocks held by the arena
+ */
+void tok_arena::cleanup(void) {
+
+	// reset tokens in use, releasing their values, then free each block
+	reset();
+	for(std::vector<token *>::iterator i = blocks.begin(); i != blocks.end(); ++i)
+		delete[] *i;
+	blocks.clear();
+}
+
+/*
+ * Resets all tokens in use, keeping blocks for reuse
+ */
+void tok_arena::reset(void) {
+
+	// reset tokens in use
+	for(size_t i = 0; i < used; i++)
+		blocks.at(i / BLOCK_SIZE)[i % BLOCK_SIZE].reset();
+	used = 0;
+}
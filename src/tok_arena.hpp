@@ -0,0 +1,83 @@
+/*
+ * Cli Calc -- a small CLI calculator
+ * Copyright (C) 2012 David Jolly
+ * ----------------------
+ * This file is part of Cli Calc
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TOK_ARENA_HPP_
+#define TOK_ARENA_HPP_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "token.hpp"
+
+class tok_arena {
+private:
+
+	size_t used;
+	std::vector<token *> blocks;
+
+public:
+
+	/*
+	 * Number of tokens allocated at a time
+	 */
+	static const size_t BLOCK_SIZE = 1 << 10;
+
+	/*
+	 * Token arena constructor
+	 */
+	tok_arena(void) : used(0) { return; }
+
+	/*
+	 * Token arena constructor (arenas are not shared, a copy starts empty)
+	 */
+	tok_arena(const tok_arena &) : used(0) { return; }
+
+	/*
+	 * Token arena destructor
+	 */
+	virtual ~tok_arena(void) { cleanup(); }
+
+	/*
+	 * Token arena assignment (arenas are not shared, tokens in use are reset)
+	 */
+	tok_arena &operator=(const tok_arena &other);
+
+	/*
+	 * Returns a token from the arena, set to the given text, type & parent
+	 */
+	token *allocate(const std::string &text, unsigned int type, token *parent);
+
+	/*
+	 * Release all blocks held by the arena
+	 */
+	void cleanup(void);
+
+	/*
+	 * Returns the number of tokens in use
+	 */
+	size_t get_count(void) { return used; }
+
+	/*
+	 * Resets all tokens in use, keeping blocks for reuse
+	 */
+	void reset(void);
+};
+
+#endif
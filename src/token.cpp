@@ -18,6 +18,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <sstream>
 #include "token.hpp"
 
 /*
@@ -25,17 +26,21 @@
  */
 token::token(void) {
 	type = UNDEFINED;
+	code = 0;
+	count = 0;
 	parent = NULL;
+	child = NULL;
+	sibling = NULL;
 }
 
 /*
  * Token constructor
  */
-token::token(const token &other) : type(other.type), parent(other.parent) {
+token::token(const token &other) : type(other.type), code(other.code), count(other.count), value(other.value), parent(other.parent),
+		child(other.child), sibling(NULL) {
 
-	// set attributes
+	// set attributes (children are shared)
 	text.assign(other.text);
-	children.assign(other.children.begin(), other.children.end());
 }
 
 /*
@@ -45,7 +50,11 @@ token::token(const unsigned int type, token *parent) {
 
 	// set attributes
 	this->type = type;
+	code = 0;
+	count = 0;
 	this->parent = parent;
+	child = NULL;
+	sibling = NULL;
 }
 
 /*
@@ -55,7 +64,11 @@ token::token(const std::string &text, const unsigned int type, token *parent) {
 
 	// set attributes
 	this->type = type;
+	code = 0;
+	count = 0;
 	this->parent = parent;
+	child = NULL;
+	sibling = NULL;
 	this->text.assign(text);
 }
 
@@ -66,17 +79,22 @@ token::token(const std::string &text, const unsigned int type, token *parent, co
 
 	// set attributes
 	this->type = type;
+	code = 0;
+	count = 0;
 	this->parent = parent;
+	child = NULL;
+	sibling = NULL;
 	this->text.assign(text);
-	this->children.assign(children.begin(), children.end());
+	set_children(children);
 }
 
 /*
  * Token destructor
  */
 token::~token(void) {
+
+	// children are not owned, links are left to their tree
 	text.clear();
-	remove_children();
 }
 
 /*
@@ -88,11 +106,14 @@ token &token::operator=(const token &other) {
 	if(this == &other)
 		return *this;
 
-	// set attributes
+	// set attributes (children are shared, siblings are kept)
 	type = other.type;
+	code = other.code;
+	count = other.count;
 	parent = other.parent;
+	child = other.child;
 	text.assign(other.text);
-	children.assign(other.children.begin(), other.children.end());
+	value = other.value;
 	return *this;
 }
 
@@ -100,7 +121,7 @@ token &token::operator=(const token &other) {
  * Token equivalence
  */
 bool token::operator==(const token &other) {
-	unsigned int i;
+	token *a = child, *b = other.child;
 
 	// check for same object
 	if(this == &other)
@@ -108,12 +129,14 @@ bool token::operator==(const token &other) {
 
 	// check if all attributes match
 	if(type != other.type
+			|| code != other.code
 			|| text != other.text
+			|| value != other.value
 			|| parent != other.parent
-			|| size() != other.children.size())
+			|| count != other.count)
 		return false;
-	for(i = 0; i < size(); i++)
-		if(children.at(i) != other.children.at(i))
+	for(; a; a = a->sibling, b = b->sibling)
+		if(a != b)
 			return false;
 	return true;
 }
@@ -122,55 +145,39 @@ bool token::operator==(const token &other) {
  * Add child to token children
  */
 token *token::add_child(token *child) {
+	token *last = this->child;
 
 	// return null
 	if(!child)
 		return NULL;
 
-	// add child to back of children vector & return child
-	children.push_back(child);
-	return children.back();
-}
-
-/*
- * Converts a string to a float
- */
-bool token::convert_to_float(mpf_t &out, std::string &str) {
-
-	// check if string is empty
-	if(str.empty())
-		return false;
-
-	// return conversion
-	mpf_init_set_str(out, str.c_str(), 10);
-	return true;
-}
-
-/*
- * Converts a string to an integer
- */
-bool token::convert_to_integer(mpz_t &out, std::string &str) {
-
-	// check if string is empty
-	if(str.empty())
-		return false;
-
-	// return conversion
-	mpz_init_set_str(out, str.c_str(), 10);
-	return true;
+	// link child to the back of the children & return child
+	child->sibling = NULL;
+	if(!last)
+		this->child = child;
+	else {
+		while(last->sibling)
+			last = last->sibling;
+		last->sibling = child;
+	}
+	count++;
+	return child;
 }
 
 /*
  * Returns a token child at a given index
  */
 token *token::get_child(unsigned int index) {
+	token *child = this->child;
 
 	// check if out-of-bounds
 	if(index >= size())
 		return NULL;
 
-	// return child at given index
-	return children.at(index);
+	// walk the children to the given index
+	while(index--)
+		child = child->sibling;
+	return child;
 }
 
 /*
@@ -179,32 +186,29 @@ token *token::get_child(unsigned int index) {
 bool token::negate(void) {
 
 	// negate the value if of type integer or float
-	if(type == INTEGER) {
-		mpz_t value;
-		convert_to_integer(value, text);
-		mpz_neg(value, value);
-		convert_to_string(value, text);
-		mpz_clear(value);
-	} else if(type == FLOAT) {
-		mpf_t value;
-		convert_to_float(value, text);
-		mpf_neg(value, value);
-		convert_to_string(value, text);
-		mpf_clear(value);
-	} else
+	if(type != INTEGER
+			&& type != FLOAT)
 		return false;
-	return true;
+	return value.negate();
 }
 
 /*
  * Removes a child held by token at a given index
  */
 bool token::remove_child(unsigned int index) {
+	token **link = &child, *removed;
 
 	// check if out-of-bounds
 	if(index >= size())
 		return false;
-	children.erase(children.begin() + index);
+
+	// unlink the child at the given index
+	while(index--)
+		link = &(*link)->sibling;
+	removed = *link;
+	*link = removed->sibling;
+	removed->sibling = NULL;
+	count--;
 	return true;
 }
 
@@ -213,26 +217,85 @@ bool token::remove_child(unsigned int index) {
  */
 void token::remove_children(void) {
 
-	// remove children until none exist
-	while(!children.empty())
-		remove_child(0);
+	// unlink children until none exist
+	while(child) {
+		token *next = child->sibling;
+		child->sibling = NULL;
+		child = next;
+	}
+	count = 0;
+}
+
+/*
+ * Resets the token to an undefined state, releasing its value & children
+ */
+void token::reset(void) {
+	type = UNDEFINED;
+	code = 0;
+	parent = NULL;
+	sibling = NULL;
+	text.clear();
+	value.clear();
+	remove_children();
+}
+
+/*
+ * Set the tokens children
+ */
+void token::set_children(const std::vector<token *> &children) {
+
+	// link each child in order
+	remove_children();
+	for(std::vector<token *>::const_iterator i = children.begin(); i != children.end(); ++i)
+		add_child(*i);
+}
+
+/*
+ * Set the tokens numeric value (and matching type)
+ */
+void token::set_value(const num_value &value) {
+
+	// set value & the type that matches it
+	this->value = value;
+	if(this->value.is_integer())
+		type = INTEGER;
+	else if(this->value.is_float())
+		type = FLOAT;
+}
+
+/*
+ * Exchange the tokens numeric value with the given value (and match type)
+ */
+void token::swap_value(num_value &value) {
+
+	// exchange values without copying & set the type that matches it
+	this->value.swap(value);
+	if(this->value.is_integer())
+		type = INTEGER;
+	else if(this->value.is_float())
+		type = FLOAT;
 }
 
 /*
  * Returns a string representation of the current state of the token
  */
 void token::to_string(std::string &str) {
+	std::string val;
 	std::stringstream ss;
 
 	// convert token type to string
 	type_to_string(type, str);
 
-	// append text & size if appropriate
-	if(!text.empty()) {
+	// append text (or value) & size if appropriate
+	value.to_string(val);
+	if(!val.empty()) {
+		str.append(": ");
+		str.append(val);
+	} else if(!text.empty()) {
 		str.append(": ");
 		str.append(text);
 	}
-	ss << " (" << children.size() << ")";
+	ss << " (" << count << ")";
 
 	// assign to str
 	str.append(ss.str());
@@ -23,17 +23,19 @@
 
 #include <cstdint>
 #include <gmp.h>
-#include <sstream>
 #include <string>
 #include <vector>
+#include "num_value.hpp"
 
 class token {
 private:
 
 	unsigned int type;
+	unsigned int code;
 	std::string text;
-	token *parent;
-	std::vector<token *> children;
+	unsigned int count;
+	num_value value;
+	token *parent, *child, *sibling;
 
 	/*
 	 * Returns a string representation of the given type
@@ -48,11 +50,6 @@ public:
 	enum TYPE { UNDEFINED, ASSIGNMENT, BEGIN, BINARY_OPER, CLOSE_PAREN, CONSTANT, END, EXPRESSION, FLOAT, FUNCTION, INTEGER,
 				LOGICAL_OPER, OPER, OPEN_PAREN, STRING, UNARY_OPER };
 
-	/*
-	 * Value precision
-	 */
-	static const unsigned int PRECISION = 20;
-
 	/*
 	 * Token constructor
 	 */
@@ -104,52 +101,24 @@ public:
 	token *add_child(token *child);
 
 	/*
-	 * Converts a string to another type
-	 */
-	template<class T>
-	static T convert_to(std::string &str) {
-		T out;
-		std::stringstream stream(str);
-
-		// return the conversion of a string into an object of type T
-		stream >> out;
-		return out;
-	}
-
-	/*
-	 * Converts a string to a float
-	 */
-	static bool convert_to_float(mpf_t &out, std::string &str);
-
-	/*
-	 * Converts a string to an integer
+	 * Returns a token child at a given index
 	 */
-	static bool convert_to_integer(mpz_t &out, std::string &str);
+	token *get_child(unsigned int index);
 
 	/*
-	 * Converts a type to a string
+	 * Returns the token's first child (children are linked through their siblings)
 	 */
-	template<class T>
-	static void convert_to_string(T &val, std::string &out) {
-		std::stringstream stream;
-
-		// set precision
-		stream.precision(PRECISION);
-
-		// return the conversion of an object of type T into a string
-		stream << val;
-		out = stream.str();
-	}
+	token *get_first(void) { return child; }
 
 	/*
-	 * Returns a token child at a given index
+	 * Returns the token's next sibling
 	 */
-	token *get_child(unsigned int index);
+	token *get_next(void) { return sibling; }
 
 	/*
-	 * Returns all children currently held by the token
+	 * Returns the token's code (keyword index, interned identifier or 0)
 	 */
-	std::vector<token *> &get_children(void) { return children; }
+	unsigned int get_code(void) { return code; }
 
 	/*
 	 * Returns the token's parent
@@ -166,6 +135,11 @@ public:
 	 */
 	std::string &get_text(void) { return text; }
 
+	/*
+	 * Returns the token's numeric value
+	 */
+	num_value &get_value(void) { return value; }
+
 	/*
 	 * Negates the current word token's value if possible
 	 */
@@ -181,10 +155,20 @@ public:
 	 */
 	void remove_children(void);
 
+	/*
+	 * Resets the token to an undefined state, releasing its value & children
+	 */
+	void reset(void);
+
 	/*
 	 * Set the tokens children
 	 */
-	void set_children(const std::vector<token *> &children) { this->children.assign(children.begin(), children.end()); }
+	void set_children(const std::vector<token *> &children);
+
+	/*
+	 * Set the tokens code
+	 */
+	void set_code(unsigned int code) { this->code = code; }
 
 	/*
 	 * Set the tokens parent
@@ -201,10 +185,20 @@ public:
 	 */
 	void set_type(unsigned int type) { this->type = type; }
 
+	/*
+	 * Set the tokens numeric value (and matching type)
+	 */
+	void set_value(const num_value &value);
+
+	/*
+	 * Exchange the tokens numeric value with the given value (and match type)
+	 */
+	void swap_value(num_value &value);
+
 	/*
 	 * Return the number of children currently held by the token
 	 */
-	unsigned int size(void) { return children.size(); }
+	unsigned int size(void) { return count; }
 
 	/*
 	 * Returns a string representation of the current state of the token
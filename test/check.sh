@@ -0,0 +1,41 @@
+#!/bin/sh
+# Cli Calc regression checks
+# Copyright (C) 2012 David Jolly
+#
+# Usage: check.sh <cli-calc binary>
+
+APP=${1:-./cli-calc}
+FAILED=0
+
+# check EXPECTED ARG...: runs the calculator over the arguments, comparing its output
+check() {
+	expected=$1
+	shift
+	actual=$("$APP" "$@" 2>&1)
+	if [ "$actual" != "$expected" ]; then
+		echo "FAIL: $* -> '$actual' (expected '$expected')"
+		FAILED=1
+	fi
+}
+
+# fused sums holding a float shift of a literal power of 2
+check "6" "make a 1 make b 2 make c 1.5" "a + b + c * 2"
+
+# fused sums adding integer terms exactly alongside floats
+check "1.5" "make a (2 ^ 80 + 1) make b (0 - 2 ^ 80) make c 0.5 (a + b) + c"
+
+# fused products keep the grouping of float multiplies
+check "8.88178419700125e-16" --fast "make a 1.1 make b 1.3 make c 1.7 make d 1.9" "(a * b) * (c * d) - a * (b * (c * d))"
+check "-2.77555756156289e-17" --fast "make a 0.3 make b 0.6 make c 0.7 make d 1.1" "a * b * c * d - ((a * b) * c) * d"
+
+# registers pooled by an earlier statement do not count against the memory limit
+terms="y"
+for i in 1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16 17 18 19 20 21 22 23 24 25 26 27 28 29; do
+	terms="$terms + y"
+done
+check "$(printf '78270\n72248')" --max-mem 1 "make y (2 ^ 260000)" "make x (2 ^ 120000)" "digits ($terms)" "digits (x * x)"
+
+if [ $FAILED -ne 0 ]; then
+	exit 1
+fi
+echo "All checks passed"